@@ -0,0 +1,199 @@
+#ifndef FEUP_AED_CSVREADER_H
+#define FEUP_AED_CSVREADER_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Class that reads a csv file row by row, handing out the fields as string_views into its own buffer
+ * @details The file is read in large blocks and every row is split in place: a quoted field ("a, ""b""") has its quotes
+ * removed by shifting its characters inside the buffer, so no field is ever copied. The buffer only grows for a row longer
+ * than it, and the field list is reused, so reading a row allocates nothing. A UTF-8 byte order mark at the start of the
+ * file is skipped and a trailing '\r' is dropped from every row.
+ * The views returned by field() are only valid until the next call to readRow().
+ * Shared by both projects, it only depends on the standard library.
+ */
+class CsvReader {
+private:
+    FILE *file_ = nullptr;
+    /** @brief Owned block buffer when reading a file */
+    vector<char> buffer_;
+    /** @brief The bytes being split, either buffer_ or the caller's memory */
+    char *data_ = nullptr;
+    /** @brief Start of the next row and end of the valid data in data_ */
+    size_t pos_ = 0, end_ = 0;
+    bool eof_ = false;
+    /** @brief Whether the file could be opened, always true when reading from memory */
+    bool open_ = false;
+    char delimiter_;
+    /** @brief Offset from the row start and length of every field of the current row */
+    vector<pair<uint32_t, uint32_t>> spans_;
+    vector<string_view> fields_;
+
+    /**
+     * @brief Reads the next block, first moving the current row to the start of the buffer (and growing it if the row fills it).
+     * Every index into the current row is shifted along.
+     * @return Whether any byte was read.
+     */
+    bool more(size_t &rowStart, size_t &i, size_t &fieldStart, size_t &write) {
+        if (eof_ || file_ == nullptr) {
+            return false;
+        }
+        if (rowStart > 0) {
+            memmove(data_, data_ + rowStart, end_ - rowStart);
+            end_ -= rowStart;
+            i -= rowStart;
+            fieldStart -= rowStart;
+            write -= rowStart;
+            rowStart = 0;
+        }
+        if (end_ == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+            data_ = buffer_.data();
+        }
+        size_t read = fread(data_ + end_, 1, buffer_.size() - end_, file_);
+        if (read == 0) {
+            eof_ = true;
+            return false;
+        }
+        end_ += read;
+        return true;
+    }
+
+public:
+    /**
+     * @brief Opens a csv file; check isOpen() before reading.
+     * @details Time complexity - O(1)
+     * @param path The file to read.
+     * @param delimiter The field separator.
+     * @param blockSize The number of bytes read from the file at once.
+     */
+    explicit CsvReader(const string &path, char delimiter = ',', size_t blockSize = 1 << 16)
+        : buffer_(blockSize < 16 ? 16 : blockSize), data_(buffer_.data()), delimiter_(delimiter) {
+        file_ = fopen(path.c_str(), "rb");
+        open_ = file_ != nullptr;
+        spans_.reserve(16);
+        fields_.reserve(16);
+        size_t rowStart = 0, i = 0, fieldStart = 0, write = 0;
+        if (more(rowStart, i, fieldStart, write) && end_ >= 3 && memcmp(data_, "\xEF\xBB\xBF", 3) == 0) {
+            pos_ = 3;
+        }
+    }
+
+    /**
+     * @brief Splits rows out of memory the caller owns, such as one chunk of a file loaded at once.
+     * @details Quoted fields are unquoted inside that memory. No byte order mark is looked for.
+     * Time complexity - O(1)
+     * @param begin The first byte of the rows, the memory must stay valid while the reader is used.
+     * @param end One past the last byte of the rows.
+     * @param delimiter The field separator.
+     */
+    CsvReader(char *begin, char *end, char delimiter = ',') : data_(begin), end_(end - begin), eof_(true), open_(true), delimiter_(delimiter) {
+        spans_.reserve(16);
+        fields_.reserve(16);
+    }
+
+    CsvReader(const CsvReader &) = delete;
+    CsvReader &operator=(const CsvReader &) = delete;
+
+    ~CsvReader() {
+        if (file_ != nullptr) {
+            fclose(file_);
+        }
+    }
+
+    bool isOpen() const { return open_; }
+
+    /**
+     * @brief Advances to the next row of the file.
+     * @details Time complexity - O(r), where r is the length of the row
+     * @return False once there are no rows left.
+     */
+    bool readRow() {
+        spans_.clear();
+        fields_.clear();
+        size_t rowStart = pos_, i = pos_, fieldStart = pos_, write = pos_;
+        bool inQuotes = false, ended = false;
+        while (!ended) {
+            if (i == end_ && !more(rowStart, i, fieldStart, write)) {
+                if (i == rowStart) {
+                    return false;
+                }
+                break; // last row without a line break
+            }
+            char c = data_[i];
+            if (inQuotes) {
+                if (c == '"') {
+                    if (i + 1 == end_) {
+                        more(rowStart, i, fieldStart, write);
+                    }
+                    if (i + 1 < end_ && data_[i + 1] == '"') { // escaped quote
+                        data_[write++] = '"';
+                        i += 2;
+                    } else {
+                        inQuotes = false;
+                        i++;
+                    }
+                } else {
+                    data_[write++] = c;
+                    i++;
+                }
+            } else if (c == '"' && write == fieldStart) {
+                inQuotes = true;
+                i++;
+            } else if (c == delimiter_) {
+                spans_.emplace_back(fieldStart - rowStart, write - fieldStart);
+                fieldStart = write = ++i;
+            } else if (c == '\n') {
+                ended = true;
+                i++;
+            } else {
+                data_[write++] = c;
+                i++;
+            }
+        }
+        if (write > fieldStart && data_[write - 1] == '\r') {
+            write--;
+        }
+        spans_.emplace_back(fieldStart - rowStart, write - fieldStart);
+        pos_ = i;
+        for (const auto &span : spans_) {
+            fields_.emplace_back(data_ + rowStart + span.first, span.second);
+        }
+        return true;
+    }
+
+    /** @brief Number of fields of the current row. */
+    size_t size() const { return fields_.size(); }
+
+    /** @brief The i-th field of the current row, empty if the row has fewer fields. */
+    string_view field(size_t i) const { return i < fields_.size() ? fields_[i] : string_view(); }
+
+    /**
+     * @brief Parses the i-th field of the current row as a number, with from_chars.
+     * @details Time complexity - O(l), where l is the length of the field
+     * @return Whether the whole field is a valid number; value is left untouched otherwise.
+     */
+    template <class T>
+    bool get(size_t i, T &value) const {
+        string_view f = field(i);
+        T parsed;
+        auto res = from_chars(f.data(), f.data() + f.size(), parsed);
+        if (res.ec != errc() || res.ptr != f.data() + f.size() || f.empty()) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+};
+
+
+#endif //FEUP_AED_CSVREADER_H
@@ -17,16 +17,10 @@ DataProcessor::DataProcessor(){
  */
 
 void DataProcessor::classes_per_uc() {
-    ifstream file("classes_per_uc.csv");
-    string header;
-    getline(file,header);
-    string line;
-    while (getline(file,line)){
-        istringstream separated_comma(line);
-        string classCode , ucCode;
-        getline(separated_comma,ucCode,',');
-        getline(separated_comma,classCode,',');
-        existingClassesUc.insert(Class_UC(classCode,ucCode));
+    CsvReader file("classes_per_uc.csv");
+    file.readRow(); // header
+    while (file.readRow()){
+        existingClassesUc.insert(Class_UC(string(file.field(1)),string(file.field(0))));
     }
 }
 /**
@@ -50,20 +44,17 @@ const set<Schedule> &DataProcessor::getSchedules() const{
  * @details Time complexity - O(n) with n being the number of lines of the file
  */
 void DataProcessor::students_classes() {
-    ifstream file("students_classes.csv");
-    string header;
-    getline(file,header);
-    string line;
+    CsvReader file("students_classes.csv");
+    file.readRow(); // header, the reader skips its byte order mark
     Student lastSeenStudent;
     set<Class_UC> setOfClasses;
     bool first_it = true;
-    while (getline(file,line)){
-        istringstream separate_comma(line);
-        string ucCode,classCode,studentName,studentCode;
-        getline(separate_comma,studentCode,',');
-        getline(separate_comma,studentName,',');
-        getline(separate_comma,ucCode,',');
-        separate_comma >> classCode;
+    string ucCode,classCode,studentName,studentCode;
+    while (file.readRow()){
+        studentCode.assign(file.field(0));
+        studentName.assign(file.field(1));
+        ucCode.assign(file.field(2));
+        classCode.assign(file.field(3));
         if(first_it) {
             setOfClasses.insert(Class_UC(classCode, ucCode));
             lastSeenStudent = Student(studentName, studentCode, setOfClasses);
@@ -90,22 +81,17 @@ void DataProcessor::students_classes() {
  */
 
 void DataProcessor::classes(){
-    ifstream file("classes.csv");
-    string header;
-    getline(file,header);
-    string line;
-    while (getline(file,line)){
-        istringstream separate_comma(line);
-        string classCode,ucCode,weekday,type;
-        float duration,startHour;
-        getline(separate_comma, classCode, ',');
-        getline(separate_comma, ucCode, ',');
-        getline(separate_comma, weekday, ',');
-        separate_comma >> startHour;
-        separate_comma.ignore();
-        separate_comma >> duration;
-        separate_comma.ignore();
-        separate_comma >> type;
+    CsvReader file("classes.csv");
+    file.readRow(); // header
+    string classCode,ucCode,weekday,type;
+    while (file.readRow()){
+        float duration = 0,startHour = 0;
+        classCode.assign(file.field(0));
+        ucCode.assign(file.field(1));
+        weekday.assign(file.field(2));
+        file.get(3, startHour);
+        file.get(4, duration);
+        type.assign(file.field(5));
         Lecture lecture = Lecture(duration,startHour,type,weekday,ucCode);
         auto it = schedules.find(classCode);
         if (it != schedules.end()) {
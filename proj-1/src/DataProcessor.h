@@ -12,6 +12,7 @@
 #include <map>
 #include <climits>
 #include "Request.h"
+#include "../../common/CsvReader.h"
 
 using namespace std;
 /**
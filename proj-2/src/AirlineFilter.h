@@ -0,0 +1,52 @@
+#ifndef PROJETO_AED_2_AIRLINEFILTER_H
+#define PROJETO_AED_2_AIRLINEFILTER_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Class that holds the airlines a route query may fly with, as a dense bitset over the airline ids
+ * @details Testing a flight is a shift and a mask, with no hashing and no allocation, and a filter that allows every airline
+ * answers before touching the bitset, so traversals can check every flight they follow at almost no cost.
+ */
+class AirlineFilter {
+private:
+    vector<uint64_t> bits_;
+    bool all_ = false;
+
+public:
+    /** @brief Filter that allows no airline until some are allowed */
+    AirlineFilter() = default;
+
+    /** @brief Filter that allows every airline, including those added to the network later */
+    static AirlineFilter allAirlines() {
+        AirlineFilter filter;
+        filter.all_ = true;
+        return filter;
+    }
+
+    /**
+     * @brief Allows the flights of one more airline.
+     * @details Time complexity - O(1) amortized
+     */
+    void allow(uint16_t airline) {
+        if (airline / 64 >= bits_.size()) {
+            bits_.resize(airline / 64 + 1, 0);
+        }
+        bits_[airline / 64] |= (uint64_t) 1 << (airline % 64);
+    }
+
+    void allowAll() { all_ = true; }
+
+    bool allowsAll() const { return all_; }
+
+    /** @brief Whether the flights of an airline may be taken. */
+    bool allows(uint16_t airline) const {
+        return all_ || (airline / 64 < bits_.size() && (bits_[airline / 64] >> (airline % 64) & 1));
+    }
+};
+
+
+#endif //PROJETO_AED_2_AIRLINEFILTER_H
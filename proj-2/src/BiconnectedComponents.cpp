@@ -0,0 +1,156 @@
+#include "BiconnectedComponents.h"
+#include <algorithm>
+
+/**
+ * @brief Builds the undirected view of the flight graph: every airport gets the airports it flies to or is flown from, once.
+ * @details Time complexity - O(V + E log d), where d is the largest degree
+ */
+void BiconnectedComponents::buildUndirected(const CSRGraph &csr) {
+    uint32_t n = csr.numVertices();
+    offsets_.assign(1, 0);
+    offsets_.reserve(n + 1);
+    neighbours_.clear();
+    neighbours_.reserve(2 * (size_t) csr.numEdges());
+    for (uint32_t v = 0; v < n; v++) {
+        size_t first = neighbours_.size();
+        neighbours_.insert(neighbours_.end(), csr.targets.begin() + csr.begin(v), csr.targets.begin() + csr.end(v));
+        neighbours_.insert(neighbours_.end(), csr.inSources.begin() + csr.inBegin(v), csr.inSources.begin() + csr.inEnd(v));
+        sort(neighbours_.begin() + first, neighbours_.end());
+        neighbours_.erase(unique(neighbours_.begin() + first, neighbours_.end()), neighbours_.end());
+        neighbours_.erase(remove(neighbours_.begin() + first, neighbours_.end(), v), neighbours_.end());
+        offsets_.push_back(neighbours_.size());
+    }
+}
+
+/**
+ * @brief Finds the articulation points, bridges and biconnected components of the flight graph seen as undirected.
+ * @details Every airport gets a discovery time and a low link, the earliest discovery time reachable from its subtree through
+ * one back edge. When the search returns from a child v to u with low[v] >= disc[u], nothing below v reaches above u: u separates
+ * v's subtree (an articulation point unless it is a root with a single child) and the edges pushed since (u, v) form a
+ * biconnected component; if low[v] > disc[u] the edge (u, v) alone is a bridge. Airports without flights belong to no component.
+ * Time complexity - O(V + E log d), the search itself being O(V + E)
+ * @param csr The frozen flight graph.
+ */
+void BiconnectedComponents::build(const CSRGraph &csr) {
+    buildUndirected(csr);
+    uint32_t n = csr.numVertices();
+    const uint32_t NONE = UINT32_MAX;
+    struct Frame {
+        uint32_t v;
+        uint32_t parent;
+        uint32_t next;  // position of the next neighbour to look at
+    };
+    vector<uint32_t> disc(n, 0), low(n, 0), componentOf(n, NONE);
+    vector<bool> isArticulation(n, false);
+    vector<Frame> stack;
+    vector<pair<uint32_t, uint32_t>> edges;
+    articulationPoints_.clear();
+    bridges_.clear();
+    componentOffsets_.assign(1, 0);
+    componentAirports_.clear();
+    uint32_t time = 0;
+    for (uint32_t root = 0; root < n; root++) {
+        if (disc[root] != 0 || offsets_[root] == offsets_[root + 1]) {
+            continue;
+        }
+        uint32_t rootChildren = 0;
+        disc[root] = low[root] = ++time;
+        stack.push_back({root, NONE, offsets_[root]});
+        while (!stack.empty()) {
+            Frame &frame = stack.back();
+            uint32_t v = frame.v;
+            if (frame.next < offsets_[v + 1]) {
+                uint32_t w = neighbours_[frame.next++];
+                if (disc[w] == 0) { // tree edge, frame is not used after the push
+                    edges.emplace_back(v, w);
+                    disc[w] = low[w] = ++time;
+                    stack.push_back({w, v, offsets_[w]});
+                } else if (w != frame.parent && disc[w] < disc[v]) { // back edge
+                    edges.emplace_back(v, w);
+                    low[v] = min(low[v], disc[w]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (stack.empty()) {
+                break;
+            }
+            uint32_t u = stack.back().v;
+            low[u] = min(low[u], low[v]);
+            if (low[v] < disc[u]) {
+                continue;
+            }
+            if (u == root) {
+                rootChildren++;
+            } else {
+                isArticulation[u] = true;
+            }
+            if (low[v] > disc[u]) {
+                bridges_.emplace_back(u, v);
+            }
+            uint32_t id = componentOffsets_.size() - 1;
+            while (true) {
+                pair<uint32_t, uint32_t> edge = edges.back();
+                edges.pop_back();
+                for (uint32_t airport : {edge.first, edge.second}) {
+                    if (componentOf[airport] != id) {
+                        componentOf[airport] = id;
+                        componentAirports_.push_back(airport);
+                    }
+                }
+                if (edge.first == u && edge.second == v) {
+                    break;
+                }
+            }
+            componentOffsets_.push_back(componentAirports_.size());
+        }
+        if (rootChildren > 1) {
+            isArticulation[root] = true;
+        }
+    }
+    for (uint32_t v = 0; v < n; v++) {
+        if (isArticulation[v]) {
+            articulationPoints_.push_back(v);
+        }
+    }
+}
+
+/**
+ * @brief Airports whose removal disconnects other airports from each other, in ascending id order.
+ * @details Time complexity - O(1)
+ */
+const vector<uint32_t> &BiconnectedComponents::articulationPoints() const {
+    return articulationPoints_;
+}
+
+/**
+ * @brief Routes, flown in either direction, whose removal disconnects airports from each other.
+ * @details Time complexity - O(1)
+ */
+const vector<pair<uint32_t, uint32_t>> &BiconnectedComponents::bridges() const {
+    return bridges_;
+}
+
+/**
+ * @brief Number of biconnected components.
+ * @details Time complexity - O(1)
+ */
+uint32_t BiconnectedComponents::numComponents() const {
+    return componentOffsets_.size() - 1;
+}
+
+/**
+ * @brief Airports of the i-th biconnected component; an articulation point belongs to several components.
+ * @details Time complexity - O(s), where s is the size of the component
+ */
+vector<uint32_t> BiconnectedComponents::component(uint32_t i) const {
+    return vector<uint32_t>(componentAirports_.begin() + componentOffsets_[i], componentAirports_.begin() + componentOffsets_[i + 1]);
+}
+
+/**
+ * @brief Number of airports of the i-th biconnected component.
+ * @details Time complexity - O(1)
+ */
+uint32_t BiconnectedComponents::componentSize(uint32_t i) const {
+    return componentOffsets_[i + 1] - componentOffsets_[i];
+}
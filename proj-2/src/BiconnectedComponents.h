@@ -0,0 +1,45 @@
+#ifndef PROJETO_AED_2_BICONNECTEDCOMPONENTS_H
+#define PROJETO_AED_2_BICONNECTEDCOMPONENTS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * @brief Class that decomposes the flight network, seen as undirected, into biconnected components
+ * @details Two airports are neighbours when there is a flight between them in either direction. The Hopcroft-Tarjan
+ * depth first search runs with an explicit stack of (airport, next neighbour) frames over integer ids, so its depth is
+ * not bounded by the call stack, and finds in one linear pass the articulation points (airports whose removal disconnects
+ * other airports), the bridges (routes whose removal does) and the edge sets of every biconnected component, kept as the
+ * lists of their airports.
+ */
+class BiconnectedComponents {
+private:
+    /** @brief Undirected neighbours of every airport, without duplicates or self loops, grouped as in a CSR */
+    vector<uint32_t> offsets_;
+    vector<uint32_t> neighbours_;
+    /** @brief Articulation points, in ascending id order */
+    vector<uint32_t> articulationPoints_;
+    /** @brief Bridges, as (airport closer to the root of the search, other airport) */
+    vector<pair<uint32_t, uint32_t>> bridges_;
+    /** @brief Airports of every component, grouped as in a CSR */
+    vector<uint32_t> componentOffsets_;
+    vector<uint32_t> componentAirports_;
+
+    void buildUndirected(const CSRGraph &csr);
+
+public:
+    void build(const CSRGraph &csr);
+
+    const vector<uint32_t> &articulationPoints() const;
+    const vector<pair<uint32_t, uint32_t>> &bridges() const;
+    uint32_t numComponents() const;
+    vector<uint32_t> component(uint32_t i) const;
+    uint32_t componentSize(uint32_t i) const;
+};
+
+
+#endif //PROJETO_AED_2_BICONNECTEDCOMPONENTS_H
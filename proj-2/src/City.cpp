@@ -33,9 +33,9 @@ string City::getCountry() const {
 /**
  * @brief Getter for the list of airports in the city.
  * @details Time complexity - O(1)
- * @return A constant reference to the vector of airport names.
+ * @return A constant reference to the vector of airport ids.
  */
-const vector<string>& City::getAirports() const {
+const vector<uint32_t>& City::getAirports() const {
     return airports_;
 }
 
@@ -60,8 +60,8 @@ void City::setCountry(const string& country) {
 /**
  * @brief Adds an airport to the list of airports in the city.
  * @details Time complexity - O(1)
- * @param airport The name of the airport to be added.
+ * @param airport The id of the airport to be added.
  */
-void City::addAirport(const string& airport) {
+void City::addAirport(uint32_t airport) {
     airports_.push_back(airport);
 }
\ No newline at end of file
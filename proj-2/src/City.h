@@ -6,6 +6,7 @@
 #define PROJETO_AED_2_CITY_H
 
 using namespace std;
+#include <cstdint>
 #include <string>
 #include <vector>
 /**
@@ -15,16 +16,16 @@ class City {
 private:
     string name_;
     string country_;
-    vector<string> airports_;
+    vector<uint32_t> airports_;
 
 public:
     City(const string& name, const string& country);
     string getName() const;
     string getCountry() const;
-    const vector<string>& getAirports() const;
+    const vector<uint32_t>& getAirports() const;
     void setName(const string& name);
     void setCountry(const string& country);
-    void addAirport(const string& airport);
+    void addAirport(uint32_t airport);
 };
 
 
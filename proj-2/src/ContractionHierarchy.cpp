@@ -0,0 +1,400 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+    const uint32_t CH_MAGIC = 0x48434541;   // "AECH"
+    const uint32_t CH_VERSION = 1;
+    /** @brief Maximum number of airports settled by one witness search */
+    const uint32_t WITNESS_LIMIT = 500;
+    const uint32_t NO_ARC = numeric_limits<uint32_t>::max();
+
+    void hashBytes(uint64_t &hash, const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    template <class T>
+    void writeValue(ofstream &out, const T &value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <class T>
+    bool readValue(ifstream &in, T &value) {
+        return (bool) in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    void writeArcs(ofstream &out, const vector<uint32_t> &offsets, const vector<ContractionHierarchy::Arc> &arcs) {
+        out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        writeValue(out, (uint32_t) arcs.size());
+        for (const auto &arc : arcs) {
+            writeValue(out, arc.to);
+            writeValue(out, arc.middle);
+            writeValue(out, arc.weight);
+            writeValue(out, arc.airline);
+        }
+    }
+
+    bool readArcs(ifstream &in, uint32_t n, vector<uint32_t> &offsets, vector<ContractionHierarchy::Arc> &arcs) {
+        offsets.resize(n + 1);
+        uint32_t count;
+        if (!in.read(reinterpret_cast<char *>(offsets.data()), offsets.size() * sizeof(uint32_t)) || !readValue(in, count)
+            || offsets[n] != count) {
+            return false;
+        }
+        arcs.resize(count);
+        for (auto &arc : arcs) {
+            if (!readValue(in, arc.to) || !readValue(in, arc.middle) || !readValue(in, arc.weight) || !readValue(in, arc.airline)
+                || arc.to >= n) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Hashes the structure and weights of a frozen graph, to tell whether a saved hierarchy still matches it.
+ * @details Time complexity - O(V+E)
+ * @param csr The frozen graph.
+ * @return A 64 bit FNV-1a hash.
+ */
+uint64_t ContractionHierarchy::fingerprint(const CSRGraph &csr) {
+    uint64_t hash = 14695981039346656037ULL;
+    hashBytes(hash, csr.offsets.data(), csr.offsets.size() * sizeof(uint32_t));
+    hashBytes(hash, csr.targets.data(), csr.targets.size() * sizeof(uint32_t));
+    hashBytes(hash, csr.weights.data(), csr.weights.size() * sizeof(double));
+    hashBytes(hash, csr.airlines.data(), csr.airlines.size() * sizeof(uint16_t));
+    return hash;
+}
+
+/**
+ * @brief Contracts every airport of the graph and stores the resulting upward and downward arcs.
+ * @details Airports are contracted in order of edge difference (shortcuts added minus arcs removed) plus the number of
+ * already contracted neighbours, with lazy updates of the priorities. A shortcut u -> w through v is skipped when a
+ * witness search from u, bounded to WITNESS_LIMIT settled airports, finds a trip to w no longer than u -> v -> w.
+ * Parallel flights are merged into the shortest one.
+ * Time complexity - O(V*(d^2 + d*W log W)) in practice, where d is the degree of an airport when it is contracted and W the witness limit
+ * @param csr The frozen flight graph.
+ */
+void ContractionHierarchy::build(const CSRGraph &csr) {
+    n_ = csr.numVertices();
+    fingerprint_ = fingerprint(csr);
+    vector<vector<Arc>> out(n_), in(n_);
+    vector<int32_t> slot(n_, -1);
+    for (uint32_t u = 0; u < n_; u++) {
+        for (uint32_t e = csr.begin(u); e < csr.end(u); e++) {
+            uint32_t v = csr.targets[e];
+            if (v == u) {
+                continue;
+            }
+            if (slot[v] == -1) {
+                slot[v] = out[u].size();
+                out[u].push_back({v, -1, csr.weights[e], csr.airlines[e]});
+            } else if (csr.weights[e] < out[u][slot[v]].weight) {
+                out[u][slot[v]].weight = csr.weights[e];
+                out[u][slot[v]].airline = csr.airlines[e];
+            }
+        }
+        for (const auto &arc : out[u]) {
+            slot[arc.to] = -1;
+            in[arc.to].push_back({u, -1, arc.weight, arc.airline});
+        }
+    }
+
+    TraversalContext witnessCtx(n_);
+    DaryHeap<4> witnessHeap;
+    vector<double> witnessDist(n_);
+    auto witness = [&](uint32_t source, uint32_t skip, double maxDist) {
+        witnessCtx.reset(n_);
+        witnessHeap.reset(n_);
+        witnessCtx.visit(source, 0);
+        witnessDist[source] = 0;
+        witnessHeap.pushOrDecrease(source, 0);
+        uint32_t settled = 0;
+        while (!witnessHeap.empty() && witnessHeap.topKey() <= maxDist && settled++ < WITNESS_LIMIT) {
+            uint32_t u = witnessHeap.pop();
+            for (const auto &arc : out[u]) {
+                double dist = witnessDist[u] + arc.weight;
+                if (arc.to == skip || (witnessCtx.isVisited(arc.to) && witnessDist[arc.to] <= dist)) {
+                    continue;
+                }
+                witnessCtx.visit(arc.to, 0);
+                witnessDist[arc.to] = dist;
+                witnessHeap.pushOrDecrease(arc.to, dist);
+            }
+        }
+    };
+    auto addShortcut = [&](uint32_t u, uint32_t w, double weight, uint32_t middle) {
+        for (auto &arc : out[u]) {
+            if (arc.to == w) {
+                if (weight < arc.weight) {
+                    arc.weight = weight;
+                    arc.middle = middle;
+                    for (auto &back : in[w]) {
+                        if (back.to == u) {
+                            back.weight = weight;
+                            back.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out[u].push_back({w, (int32_t) middle, weight, 0});
+        in[w].push_back({u, (int32_t) middle, weight, 0});
+    };
+    // returns the number of shortcuts contracting v needs, adding them unless simulate
+    auto contract = [&](uint32_t v, bool simulate) {
+        int shortcuts = 0;
+        for (const auto &incoming : in[v]) {
+            uint32_t u = incoming.to;
+            double maxOut = 0;
+            for (const auto &outgoing : out[v]) {
+                if (outgoing.to != u) {
+                    maxOut = max(maxOut, outgoing.weight);
+                }
+            }
+            witness(u, v, incoming.weight + maxOut);
+            for (const auto &outgoing : out[v]) {
+                uint32_t w = outgoing.to;
+                double dist = incoming.weight + outgoing.weight;
+                if (w == u || (witnessCtx.isVisited(w) && witnessDist[w] <= dist)) {
+                    continue;
+                }
+                shortcuts++;
+                if (!simulate) {
+                    addShortcut(u, w, dist, v);
+                }
+            }
+        }
+        return shortcuts;
+    };
+    vector<int> contractedNeighbours(n_, 0);
+    auto priority = [&](uint32_t v) {
+        return (double) contract(v, true) - (double) (in[v].size() + out[v].size()) + contractedNeighbours[v];
+    };
+
+    DaryHeap<4> order;
+    order.reset(n_);
+    for (uint32_t v = 0; v < n_; v++) {
+        order.pushOrDecrease(v, priority(v));
+    }
+    rank_.assign(n_, 0);
+    vector<vector<Arc>> up(n_), down(n_);
+    uint32_t next = 0;
+    while (!order.empty()) {
+        uint32_t v = order.pop();
+        double p = priority(v);
+        if (!order.empty() && p > order.topKey()) { // lazy update, somebody else is cheaper now
+            order.pushOrDecrease(v, p);
+            continue;
+        }
+        contract(v, false);
+        rank_[v] = next++;
+        up[v] = out[v];
+        down[v] = in[v];
+        for (const auto &arc : in[v]) {
+            auto &list = out[arc.to];
+            list.erase(remove_if(list.begin(), list.end(), [v](const Arc &a) { return a.to == v; }), list.end());
+            contractedNeighbours[arc.to]++;
+        }
+        for (const auto &arc : out[v]) {
+            auto &list = in[arc.to];
+            list.erase(remove_if(list.begin(), list.end(), [v](const Arc &a) { return a.to == v; }), list.end());
+            contractedNeighbours[arc.to]++;
+        }
+        vector<Arc>().swap(out[v]);
+        vector<Arc>().swap(in[v]);
+    }
+
+    upOffsets_.assign(n_ + 1, 0);
+    downOffsets_.assign(n_ + 1, 0);
+    up_.clear();
+    down_.clear();
+    for (uint32_t v = 0; v < n_; v++) {
+        up_.insert(up_.end(), up[v].begin(), up[v].end());
+        down_.insert(down_.end(), down[v].begin(), down[v].end());
+        upOffsets_[v + 1] = up_.size();
+        downOffsets_[v + 1] = down_.size();
+    }
+}
+
+/**
+ * @brief Writes the hierarchy to a binary file.
+ * @details Time complexity - O(V+A), where A is the number of arcs
+ * @param path The file to write.
+ * @return Whether the file was written.
+ */
+bool ContractionHierarchy::save(const string &path) const {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    writeValue(out, CH_MAGIC);
+    writeValue(out, CH_VERSION);
+    writeValue(out, fingerprint_);
+    writeValue(out, n_);
+    out.write(reinterpret_cast<const char *>(rank_.data()), rank_.size() * sizeof(uint32_t));
+    writeArcs(out, upOffsets_, up_);
+    writeArcs(out, downOffsets_, down_);
+    return (bool) out;
+}
+
+/**
+ * @brief Reads a hierarchy written by save.
+ * @details Time complexity - O(V+A), where A is the number of arcs
+ * @param path The file to read.
+ * @param fingerprint The fingerprint of the current flight graph, a file built from another graph is rejected.
+ * @return Whether a valid hierarchy for this graph was loaded; if not, the hierarchy is left empty.
+ */
+bool ContractionHierarchy::load(const string &path, uint64_t fingerprint) {
+    ifstream in(path, ios::binary);
+    uint32_t magic, version;
+    if (!in.is_open() || !readValue(in, magic) || !readValue(in, version) || magic != CH_MAGIC || version != CH_VERSION
+        || !readValue(in, fingerprint_) || fingerprint_ != fingerprint || !readValue(in, n_)) {
+        n_ = 0;
+        return false;
+    }
+    rank_.resize(n_);
+    if (!in.read(reinterpret_cast<char *>(rank_.data()), rank_.size() * sizeof(uint32_t))
+        || !readArcs(in, n_, upOffsets_, up_) || !readArcs(in, n_, downOffsets_, down_)) {
+        n_ = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Number of arcs (flights and shortcuts) of the hierarchy.
+ * @details Time complexity - O(1)
+ */
+uint32_t ContractionHierarchy::numArcs() const {
+    return up_.size() + down_.size();
+}
+
+/**
+ * @brief Finds the arc stored at an airport whose other endpoint is to.
+ * @details Time complexity - O(d), where d is the number of arcs stored at the airport
+ */
+const ContractionHierarchy::Arc &ContractionHierarchy::findArc(const vector<uint32_t> &offsets, const vector<Arc> &arcs,
+                                                               uint32_t at, uint32_t to) const {
+    uint32_t i = offsets[at];
+    while (arcs[i].to != to) {
+        i++;
+    }
+    return arcs[i];
+}
+
+/**
+ * @brief Appends the airports of the trip from -> arc.to that an arc stands for, except from, to route.
+ * @details A shortcut from -> to through m was made of the arcs from -> m (stored in down_ at m) and m -> to
+ * (stored in up_ at m), since m was contracted before both endpoints.
+ * Time complexity - O(L*d), where L is the number of flights of the unpacked trip
+ */
+void ContractionHierarchy::unpack(uint32_t from, const Arc &arc, vector<pair<uint32_t, uint16_t>> &route) const {
+    if (arc.middle == -1) {
+        route.push_back({arc.to, arc.airline});
+        return;
+    }
+    uint32_t middle = arc.middle;
+    Arc first = findArc(downOffsets_, down_, middle, from);
+    first.to = middle;
+    unpack(from, first, route);
+    unpack(middle, findArc(upOffsets_, up_, middle, arc.to), route);
+}
+
+/**
+ * @brief Shortest trip, by flown distance, from any of the sources to any of the targets.
+ * @details Runs an upward Dijkstra from the sources and a backward upward Dijkstra from the targets, always advancing the
+ * side with the smaller key, until neither can improve the best meeting airport found so far.
+ * Time complexity - O(S log S), where S is the number of airports settled, a small part of the graph
+ * @param sources The ids of the airports the trip may start at.
+ * @param targets The ids of the airports the trip may end at.
+ * @param route Filled with the airports of the trip and the airline of the flight into each of them (UINT16_MAX for the first).
+ * @param settled Set to the number of airports settled by both searches.
+ * @return The length of the trip in meters, or -1 if no target is reachable.
+ */
+double ContractionHierarchy::query(const vector<uint32_t> &sources, const vector<uint32_t> &targets,
+                                   vector<pair<uint32_t, uint16_t>> &route, uint32_t &settled) {
+    const vector<uint32_t> *offsets[2] = {&upOffsets_, &downOffsets_};
+    const vector<Arc> *arcs[2] = {&up_, &down_};
+    const vector<uint32_t> *starts[2] = {&sources, &targets};
+    for (int side = 0; side < 2; side++) {
+        ctx_[side].reset(n_);
+        heap_[side].reset(n_);
+        if (dist_[side].size() < n_) {
+            dist_[side].resize(n_);
+            parent_[side].resize(n_);
+        }
+        for (auto v : *starts[side]) {
+            ctx_[side].visit(v, 0);
+            dist_[side][v] = 0;
+            parent_[side][v] = {v, NO_ARC};
+            heap_[side].pushOrDecrease(v, 0);
+        }
+    }
+    double best = numeric_limits<double>::max();
+    uint32_t meet = NO_ARC;
+    for (auto v : sources) {
+        if (ctx_[1].isVisited(v)) {
+            best = 0;
+            meet = v;
+        }
+    }
+    settled = 0;
+    while (true) {
+        bool forward = !heap_[0].empty() && heap_[0].topKey() < best;
+        bool backward = !heap_[1].empty() && heap_[1].topKey() < best;
+        if (!forward && !backward) {
+            break;
+        }
+        int side = forward && (!backward || heap_[0].topKey() <= heap_[1].topKey()) ? 0 : 1;
+        TraversalContext &ctx = ctx_[side];
+        vector<double> &dist = dist_[side];
+        uint32_t u = heap_[side].pop();
+        ctx.setProcessing(u, true);
+        settled++;
+        for (uint32_t i = (*offsets[side])[u]; i < (*offsets[side])[u + 1]; i++) {
+            const Arc &arc = (*arcs[side])[i];
+            double d = dist[u] + arc.weight;
+            if (ctx.isVisited(arc.to) && (ctx.isProcessing(arc.to) || dist[arc.to] <= d)) {
+                continue;
+            }
+            ctx.visit(arc.to, 0);
+            dist[arc.to] = d;
+            parent_[side][arc.to] = {u, i};
+            heap_[side].pushOrDecrease(arc.to, d);
+            if (ctx_[1 - side].isVisited(arc.to) && d + dist_[1 - side][arc.to] < best) {
+                best = d + dist_[1 - side][arc.to];
+                meet = arc.to;
+            }
+        }
+    }
+    route.clear();
+    if (meet == NO_ARC) {
+        return -1;
+    }
+    vector<pair<uint32_t, uint32_t>> climb; // forward arcs, from meet down to the source
+    uint32_t v = meet;
+    for (; parent_[0][v].second != NO_ARC; v = parent_[0][v].first) {
+        climb.push_back(parent_[0][v]);
+    }
+    route.push_back({v, numeric_limits<uint16_t>::max()});
+    for (auto it = climb.rbegin(); it != climb.rend(); it++) {
+        unpack(it->first, up_[it->second], route);
+    }
+    for (v = meet; parent_[1][v].second != NO_ARC; v = parent_[1][v].first) {
+        // the arc is stored at the next airport towards the target and points back to v
+        const Arc &arc = down_[parent_[1][v].second];
+        Arc forwardArc = arc;
+        forwardArc.to = parent_[1][v].first;
+        unpack(v, forwardArc, route);
+    }
+    return best;
+}
@@ -0,0 +1,66 @@
+#ifndef PROJETO_AED_2_CONTRACTIONHIERARCHY_H
+#define PROJETO_AED_2_CONTRACTIONHIERARCHY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "DaryHeap.h"
+#include "TraversalContext.h"
+
+using namespace std;
+
+/**
+ * @brief Class that answers shortest distance queries over a frozen flight graph with a contraction hierarchy
+ * @details The preprocessing contracts the airports one by one, least important first, adding a shortcut u -> w
+ * whenever the only shortest trip from u to w went through the contracted airport. Every airport ends up with a rank,
+ * and a shortest trip always climbs in rank and then descends, so a query is two small Dijkstra searches that only
+ * follow edges to higher ranked airports, from the sources and (backwards) from the targets.
+ * The hierarchy ignores the airline of the flights; a query instance is not thread safe.
+ */
+class ContractionHierarchy {
+public:
+    /** @brief Edge of the hierarchy, either a flight or a shortcut through middle */
+    struct Arc {
+        uint32_t to;        // other endpoint, always of higher rank than the airport the arc is stored at
+        int32_t middle;     // airport the shortcut goes through, or -1 for a flight
+        double weight;      // length of the (unpacked) trip, in meters
+        uint16_t airline;   // airline of the flight, unused for shortcuts
+    };
+
+private:
+    uint32_t n_ = 0;
+    /** @brief Fingerprint of the flight graph the hierarchy was built from */
+    uint64_t fingerprint_ = 0;
+    /** @brief Contraction order of every airport */
+    vector<uint32_t> rank_;
+    /** @brief Arcs v -> to with rank[to] > rank[v], grouped by v as in a CSR */
+    vector<uint32_t> upOffsets_;
+    vector<Arc> up_;
+    /** @brief Arcs to -> v with rank[to] > rank[v], grouped by v as in a CSR */
+    vector<uint32_t> downOffsets_;
+    vector<Arc> down_;
+
+    /** @brief State of the forward (0) and backward (1) query searches */
+    TraversalContext ctx_[2];
+    vector<double> dist_[2];
+    vector<pair<uint32_t, uint32_t>> parent_[2];  // previous airport and position of the arc in up_ / down_
+    DaryHeap<4> heap_[2];
+
+    const Arc &findArc(const vector<uint32_t> &offsets, const vector<Arc> &arcs, uint32_t at, uint32_t to) const;
+    void unpack(uint32_t from, const Arc &arc, vector<pair<uint32_t, uint16_t>> &route) const;
+
+public:
+    static uint64_t fingerprint(const CSRGraph &csr);
+
+    void build(const CSRGraph &csr);
+    bool save(const string &path) const;
+    bool load(const string &path, uint64_t fingerprint);
+
+    uint32_t numArcs() const;
+    double query(const vector<uint32_t> &sources, const vector<uint32_t> &targets,
+                 vector<pair<uint32_t, uint16_t>> &route, uint32_t &settled);
+};
+
+
+#endif //PROJETO_AED_2_CONTRACTIONHIERARCHY_H
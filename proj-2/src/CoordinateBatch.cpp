@@ -0,0 +1,233 @@
+#include "CoordinateBatch.h"
+#include <cmath>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    const double RADIUS_EARTH = 6371000;
+    const double PI = M_PI;
+    const double HALF_PI = M_PI / 2;
+    const int SIN_TERMS = 12;   // up to x^23, enough for |x| <= pi/2
+    const int ASIN_TERMS = 24;  // up to x^47, enough for |x| <= 1/2
+
+    /** @brief Taylor coefficients of sin(x)/x and asin(x)/x in powers of x^2 */
+    struct Series {
+        double sin[SIN_TERMS];
+        double asin[ASIN_TERMS];
+
+        Series() {
+            sin[0] = asin[0] = 1;
+            double central = 1; // (2n)! / (4^n (n!)^2)
+            for (int n = 1; n < ASIN_TERMS; n++) {
+                if (n < SIN_TERMS) {
+                    sin[n] = -sin[n - 1] / ((2.0 * n) * (2.0 * n + 1));
+                }
+                central *= (2.0 * n - 1) / (2.0 * n);
+                asin[n] = central / (2.0 * n + 1);
+            }
+        }
+    };
+    const Series SERIES;
+
+    /** @brief One distance at a time, the fallback and the tail of the vector loops */
+    struct ScalarOps {
+        using V = double;
+        static const int WIDTH = 1;
+        static V set(double x) { return x; }
+        static V load(const double *p) { return *p; }
+        static void store(double *p, V x) { *p = x; }
+        static V gather(const double *base, const uint32_t *ids) { return base[ids[0]]; }
+        static V add(V a, V b) { return a + b; }
+        static V sub(V a, V b) { return a - b; }
+        static V mul(V a, V b) { return a * b; }
+#ifdef __FMA__
+        static V fma(V a, V b, V c) { return std::fma(a, b, c); }
+#else
+        static V fma(V a, V b, V c) { return a * b + c; }
+#endif
+        static V sqrt(V a) { return std::sqrt(a); }
+        static V abs(V a) { return std::fabs(a); }
+        static V min(V a, V b) { return a < b ? a : b; }
+        static V max(V a, V b) { return a > b ? a : b; }
+        /** @brief ifGreater where x > threshold, otherwise elsewhere */
+        static V selectGreater(V x, V threshold, V ifGreater, V otherwise) { return x > threshold ? ifGreater : otherwise; }
+    };
+
+#if defined(__AVX2__)
+    /** @brief Four distances at a time */
+    struct VectorOps {
+        using V = __m256d;
+        static const int WIDTH = 4;
+        static V set(double x) { return _mm256_set1_pd(x); }
+        static V load(const double *p) { return _mm256_loadu_pd(p); }
+        static void store(double *p, V x) { _mm256_storeu_pd(p, x); }
+        static V gather(const double *base, const uint32_t *ids) {
+            __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ids));
+            return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+        }
+        static V add(V a, V b) { return _mm256_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+#ifdef __FMA__
+        static V fma(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+        static V fma(V a, V b, V c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+        static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+        static V abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static V min(V a, V b) { return _mm256_min_pd(a, b); }
+        static V max(V a, V b) { return _mm256_max_pd(a, b); }
+        static V selectGreater(V x, V threshold, V ifGreater, V otherwise) {
+            return _mm256_blendv_pd(otherwise, ifGreater, _mm256_cmp_pd(x, threshold, _CMP_GT_OQ));
+        }
+    };
+#elif defined(__SSE2__)
+    /** @brief Two distances at a time */
+    struct VectorOps {
+        using V = __m128d;
+        static const int WIDTH = 2;
+        static V set(double x) { return _mm_set1_pd(x); }
+        static V load(const double *p) { return _mm_loadu_pd(p); }
+        static void store(double *p, V x) { _mm_storeu_pd(p, x); }
+        static V gather(const double *base, const uint32_t *ids) { return _mm_set_pd(base[ids[1]], base[ids[0]]); }
+        static V add(V a, V b) { return _mm_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+#ifdef __FMA__
+        static V fma(V a, V b, V c) { return _mm_fmadd_pd(a, b, c); }
+#else
+        static V fma(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+#endif
+        static V sqrt(V a) { return _mm_sqrt_pd(a); }
+        static V abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+        static V min(V a, V b) { return _mm_min_pd(a, b); }
+        static V max(V a, V b) { return _mm_max_pd(a, b); }
+        static V selectGreater(V x, V threshold, V ifGreater, V otherwise) {
+            V mask = _mm_cmpgt_pd(x, threshold);
+            return _mm_or_pd(_mm_and_pd(mask, ifGreater), _mm_andnot_pd(mask, otherwise));
+        }
+    };
+#else
+    using VectorOps = ScalarOps;
+#endif
+
+    /** @brief Evaluates x * (c[0] + c[1] x^2 + ... + c[n-1] x^(2n-2)) with Horner's rule */
+    template <class Ops>
+    typename Ops::V oddSeries(typename Ops::V x, const double *c, int n) {
+        typename Ops::V x2 = Ops::mul(x, x);
+        typename Ops::V p = Ops::set(c[n - 1]);
+        for (int i = n - 2; i >= 0; i--) {
+            p = Ops::fma(p, x2, Ops::set(c[i]));
+        }
+        return Ops::mul(x, p);
+    }
+
+    /** @brief sin^2(x / 2) for |x| <= 2 pi, folded into [0, pi/2] where the series converges */
+    template <class Ops>
+    typename Ops::V sinHalfSquared(typename Ops::V x) {
+        typename Ops::V half = Ops::abs(Ops::mul(x, Ops::set(0.5)));
+        half = Ops::min(half, Ops::sub(Ops::set(PI), half));
+        typename Ops::V s = oddSeries<Ops>(half, SERIES.sin, SIN_TERMS);
+        return Ops::mul(s, s);
+    }
+
+    /**
+     * @brief The Haversine formula, d = 2 R asin(sqrt(a)), which equals the 2 R atan2(sqrt(a), sqrt(1 - a)) of
+     * Coordinate::dist_coordinates. Above 1/2, asin(s) is reduced to pi/2 - 2 asin(sqrt((1 - s) / 2)).
+     */
+    template <class Ops>
+    typename Ops::V haversine(typename Ops::V lat1, typename Ops::V lon1, typename Ops::V cos1,
+                              typename Ops::V lat2, typename Ops::V lon2, typename Ops::V cos2) {
+        using V = typename Ops::V;
+        V a = Ops::fma(Ops::mul(cos1, cos2), sinHalfSquared<Ops>(Ops::sub(lon2, lon1)), sinHalfSquared<Ops>(Ops::sub(lat2, lat1)));
+        a = Ops::min(Ops::max(a, Ops::set(0)), Ops::set(1));
+        V s = Ops::sqrt(a);
+        V half = Ops::set(0.5);
+        V reduced = Ops::sqrt(Ops::mul(Ops::sub(Ops::set(1), s), half));
+        V t = Ops::selectGreater(s, half, reduced, s);
+        V r = oddSeries<Ops>(t, SERIES.asin, ASIN_TERMS);
+        r = Ops::selectGreater(s, half, Ops::sub(Ops::set(HALF_PI), Ops::add(r, r)), r);
+        return Ops::mul(Ops::set(2 * RADIUS_EARTH), r);
+    }
+
+    template <class Ops>
+    void distancesFrom(double lat, double lon, double cosLat, const double *lats, const double *lons, const double *cosLats,
+                       size_t begin, size_t end, double *res) {
+        typename Ops::V lat1 = Ops::set(lat), lon1 = Ops::set(lon), cos1 = Ops::set(cosLat);
+        for (size_t i = begin; i + Ops::WIDTH <= end; i += Ops::WIDTH) {
+            Ops::store(res + i, haversine<Ops>(lat1, lon1, cos1, Ops::load(lats + i), Ops::load(lons + i), Ops::load(cosLats + i)));
+        }
+    }
+
+    template <class Ops>
+    void pairDistances(const double *lats, const double *lons, const double *cosLats, const uint32_t *sources,
+                       const uint32_t *targets, size_t begin, size_t end, double *res) {
+        for (size_t i = begin; i + Ops::WIDTH <= end; i += Ops::WIDTH) {
+            Ops::store(res + i, haversine<Ops>(Ops::gather(lats, sources + i), Ops::gather(lons, sources + i),
+                                               Ops::gather(cosLats, sources + i), Ops::gather(lats, targets + i),
+                                               Ops::gather(lons, targets + i), Ops::gather(cosLats, targets + i)));
+        }
+    }
+}
+
+/**
+ * @brief Appends a coordinate to the batch.
+ * @details Time complexity - O(1) amortized
+ */
+void CoordinateBatch::add(const Coordinate &coordinate) {
+    double latitude = coordinate.getLatitude() * PI / 180.0;
+    latitudes_.push_back(latitude);
+    longitudes_.push_back(coordinate.getLongitude() * PI / 180.0);
+    cosLatitudes_.push_back(cos(latitude));
+}
+
+/**
+ * @brief Number of coordinates in the batch.
+ * @details Time complexity - O(1)
+ */
+size_t CoordinateBatch::size() const {
+    return latitudes_.size();
+}
+
+/**
+ * @brief Distance from one point to every coordinate of the batch.
+ * @details Time complexity - O(n), where n is the size of the batch
+ * @param from The point.
+ * @param res Receives size() distances in meters, in the order of the batch.
+ */
+void CoordinateBatch::distancesFrom(const Coordinate &from, double *res) const {
+    double lat = from.getLatitude() * PI / 180.0, lon = from.getLongitude() * PI / 180.0, cosLat = cos(lat);
+    size_t n = size(), vectorEnd = n / VectorOps::WIDTH * VectorOps::WIDTH;
+    ::distancesFrom<VectorOps>(lat, lon, cosLat, latitudes_.data(), longitudes_.data(), cosLatitudes_.data(), 0, vectorEnd, res);
+    ::distancesFrom<ScalarOps>(lat, lon, cosLat, latitudes_.data(), longitudes_.data(), cosLatitudes_.data(), vectorEnd, n, res);
+}
+
+/**
+ * @brief Distance between n pairs of coordinates of the batch, such as the airports of n flights.
+ * @details Time complexity - O(n)
+ * @param sources Position in the batch of the first coordinate of every pair.
+ * @param targets Position in the batch of the second coordinate of every pair.
+ * @param n The number of pairs.
+ * @param res Receives n distances in meters.
+ */
+void CoordinateBatch::pairDistances(const uint32_t *sources, const uint32_t *targets, size_t n, double *res) const {
+    size_t vectorEnd = n / VectorOps::WIDTH * VectorOps::WIDTH;
+    ::pairDistances<VectorOps>(latitudes_.data(), longitudes_.data(), cosLatitudes_.data(), sources, targets, 0, vectorEnd, res);
+    ::pairDistances<ScalarOps>(latitudes_.data(), longitudes_.data(), cosLatitudes_.data(), sources, targets, vectorEnd, n, res);
+}
+
+/**
+ * @brief Distance between two coordinates with the same kernel as the batches, for a flight added on its own.
+ * @details Time complexity - O(1)
+ * @return The distance in meters, equal to the one pairDistances gives for the same coordinates.
+ */
+double CoordinateBatch::distance(const Coordinate &a, const Coordinate &b) {
+    CoordinateBatch batch;
+    batch.add(a);
+    batch.add(b);
+    uint32_t source = 0, target = 1;
+    double res;
+    batch.pairDistances(&source, &target, 1, &res);
+    return res;
+}
@@ -0,0 +1,35 @@
+#ifndef PROJETO_AED_2_COORDINATEBATCH_H
+#define PROJETO_AED_2_COORDINATEBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Coordinate.h"
+
+using namespace std;
+
+/**
+ * @brief Class that stores many coordinates as a structure of arrays in radians and computes Haversine distances in bulk
+ * @details The kernels replace sin and atan2 with polynomials that are accurate to a few ulps, and run them over 4 (AVX2)
+ * or 2 (SSE2) distances at once, depending on the instruction set the project is compiled for, with a scalar fallback
+ * on other targets. Every lane runs the same operations as the fallback, so a distance does not depend on its position
+ * in the batch. The cosine of every latitude is computed once, when the coordinate is added.
+ */
+class CoordinateBatch {
+private:
+    vector<double> latitudes_;
+    vector<double> longitudes_;
+    vector<double> cosLatitudes_;
+
+public:
+    void add(const Coordinate &coordinate);
+    size_t size() const;
+
+    void distancesFrom(const Coordinate &from, double *res) const;
+    void pairDistances(const uint32_t *sources, const uint32_t *targets, size_t n, double *res) const;
+
+    static double distance(const Coordinate &a, const Coordinate &b);
+};
+
+
+#endif //PROJETO_AED_2_COORDINATEBATCH_H
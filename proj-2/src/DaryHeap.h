@@ -0,0 +1,118 @@
+#ifndef PROJETO_AED_2_DARYHEAP_H
+#define PROJETO_AED_2_DARYHEAP_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Indexed D-ary min-heap of vertex ids keyed by a double (a tentative distance)
+ * @details Every vertex in the heap knows its position, so decreaseKey is a sift-up instead of pushing a
+ * duplicate entry. A wider node (D = 4) makes the heap shallower and keeps the children of a node on the
+ * same cache line, which pays off because shortest path searches do many more decreaseKey than pop.
+ */
+template <unsigned D = 4>
+class DaryHeap {
+private:
+    /** @brief Vertex ids in heap order */
+    vector<uint32_t> heap_;
+    /** @brief Key of every vertex that is in the heap */
+    vector<double> key_;
+    /** @brief Position of every vertex in heap_, or -1 if it is not in the heap */
+    vector<int32_t> pos_;
+
+    void place(uint32_t i, uint32_t v) {
+        heap_[i] = v;
+        pos_[v] = (int32_t) i;
+    }
+
+    void siftUp(uint32_t i) {
+        uint32_t v = heap_[i];
+        while (i > 0) {
+            uint32_t parent = (i - 1) / D;
+            if (key_[heap_[parent]] <= key_[v])
+                break;
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, v);
+    }
+
+    void siftDown(uint32_t i) {
+        uint32_t v = heap_[i];
+        uint32_t n = heap_.size();
+        while (true) {
+            uint32_t first = i * D + 1;
+            if (first >= n)
+                break;
+            uint32_t last = first + D < n ? first + D : n;
+            uint32_t best = first;
+            for (uint32_t c = first + 1; c < last; c++)
+                if (key_[heap_[c]] < key_[heap_[best]])
+                    best = c;
+            if (key_[v] <= key_[heap_[best]])
+                break;
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, v);
+    }
+
+public:
+    /**
+     * @brief Empties the heap and makes room for vertex ids in [0, numVertices).
+     * @details Time complexity - O(k), where k is the number of vertices left in the heap
+     */
+    void reset(uint32_t numVertices) {
+        for (auto v : heap_)
+            pos_[v] = -1;
+        heap_.clear();
+        if (pos_.size() < numVertices) {
+            pos_.resize(numVertices, -1);
+            key_.resize(numVertices, 0);
+        }
+    }
+
+    bool empty() const { return heap_.empty(); }
+
+    bool contains(uint32_t v) const { return pos_[v] != -1; }
+
+    /** @brief Key of the vertex on top of the heap, the heap must not be empty. */
+    double topKey() const { return key_[heap_[0]]; }
+
+    /**
+     * @brief Inserts v with the given key, or lowers its key if v is already in the heap with a larger one.
+     * @details Time complexity - O(log_D(n))
+     */
+    void pushOrDecrease(uint32_t v, double key) {
+        if (pos_[v] == -1) {
+            key_[v] = key;
+            heap_.push_back(v);
+            pos_[v] = (int32_t) heap_.size() - 1;
+            siftUp(heap_.size() - 1);
+        } else if (key < key_[v]) {
+            key_[v] = key;
+            siftUp(pos_[v]);
+        }
+    }
+
+    /**
+     * @brief Removes and returns the vertex with the smallest key.
+     * @details Time complexity - O(D*log_D(n))
+     */
+    uint32_t pop() {
+        uint32_t top = heap_[0];
+        uint32_t last = heap_.back();
+        heap_.pop_back();
+        pos_[top] = -1;
+        if (!heap_.empty()) {
+            heap_[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+};
+
+
+#endif //PROJETO_AED_2_DARYHEAP_H
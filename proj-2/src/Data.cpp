@@ -1,6 +1,11 @@
 
 
 #include <climits>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <functional>
+#include <cstring>
 #include "Data.h"
 /**
  * @brief Constructor for the Data class that initializes essential data structures.
@@ -8,41 +13,47 @@
  */
 Data::Data() {
     flightG = new Graph<string>();
-    read_airlines();
-    read_airports();
-    read_flights();
+    if(!loadSnapshot(SNAPSHOT)){ // missing or older than the csv files
+        read_airlines();
+        read_airports();
+        read_flights();
+        if(!saveSnapshot(SNAPSHOT)){
+            cout << "Could not save the network snapshot" << endl;
+        }
+    }
+    buildAirportIndex();
 }
 /**
- * @brief Getter for the map of airports.
+ * @brief Getter for the airports, indexed by airport id.
  * @details Time complexity: O(1)
- * @return The unordered map of airports.
+ * @return A read-only view of the vector of airports.
  *
  */
-unordered_map<string, Airport*> Data::getAirports() {
+const vector<Airport*> &Data::getAirports() const {
     return airports_;
 }
 /**
- * @brief Getter for the map of airlines.
+ * @brief Getter for the airlines, indexed by airline id.
  * @details Time complexity: O(1)
- * @return The unordered map of airlines.
+ * @return A read-only view of the vector of airlines.
  */
-unordered_map<string, Airline*> Data::getAirlines() {
+const vector<Airline*> &Data::getAirlines() const {
     return airlines_;
 }
 /**
  * @brief Getter for the map of cities.
  * @details Time complexity: O(1)
- * @return The unordered map of cities.
+ * @return A read-only view of the unordered map of cities.
  */
-unordered_map<string, City*> Data::getCities() {
+const unordered_map<string, City*> &Data::getCities() const {
     return cities_;
 }
 /**
  * @brief Getter for the map of countries.
  * @details Time complexity: O(1)
- * @return The unordered map of countries.
+ * @return A read-only view of the unordered map of countries.
  */
-unordered_map<string, Country*> Data::getCountries() {
+const unordered_map<string, Country*> &Data::getCountries() const {
     return countries_;
 }
 /**
@@ -53,24 +64,60 @@ unordered_map<string, Country*> Data::getCountries() {
 Graph<string>* Data::getFlightG() {
     return flightG;
 }
+/**
+ * @brief Looks up the id of an airport code.
+ * @details Time complexity: O(1)
+ * @param code The IATA code of the airport.
+ * @return The airport id, which is also its vertex id in the flight graph, or -1 if the airport does not exist.
+ */
+int Data::findAirport(const string& code) const {
+    return airportIds_.find(code);
+}
+/**
+ * @brief Looks up the id of an airline code.
+ * @details Time complexity: O(1)
+ * @param code The ICAO code of the airline.
+ * @return The airline id, or -1 if the airline does not exist.
+ */
+int Data::findAirline(const string& code) const {
+    return airlineIds_.find(code);
+}
+/**
+ * @brief Getter for the code of an airport.
+ * @details Time complexity: O(1)
+ * @param id The airport id.
+ * @return The IATA code of the airport.
+ */
+const string& Data::getAirportCode(uint32_t id) const {
+    return airportIds_.getName(id);
+}
+/**
+ * @brief Getter for the code of an airline.
+ * @details Time complexity: O(1)
+ * @param id The airline id.
+ * @return The ICAO code of the airline.
+ */
+const string& Data::getAirlineCode(uint16_t id) const {
+    return airlineIds_.getName(id);
+}
 /**
  * @brief Reads airline data from a file and populates relevant data structures.
  * @details Time complexity: O(N), where N is the number of entries in the airlines.csv file.
  */
 void Data::read_airlines() {
-    string code, name, callSign, countryName;
-    ifstream input(AIRLINES);
-    if (input.is_open()) {
-        string line;
-        getline(input, line);
-        while (getline(input, line)) {
-            istringstream iss(line);
-            getline(iss, code, ',');
-            getline(iss, name, ',');
-            getline(iss, callSign, ',');
-            getline(iss, countryName, ',');
-            Airline* airline = new Airline(code, name, callSign, countryName);
-            airlines_[code] = airline;
+    string code;
+    CsvReader input(AIRLINES);
+    if (input.isOpen()) {
+        input.readRow(); // header
+        while (input.readRow()) {
+            code.assign(input.field(0));
+            Airline* airline = new Airline(code, string(input.field(1)), string(input.field(2)), string(input.field(3)));
+            if(airlineIds_.intern(code) == airlines_.size()){
+                airlines_.push_back(airline);
+            }
+            else{
+                delete airline;
+            }
         }
     } else {
         cout << "Could not open the file\n";
@@ -81,24 +128,20 @@ void Data::read_airlines() {
 * @details Time complexity: O(N), where N is the number of entries in the airports.csv file.
  */
 void Data::read_airports() {
-    double latitude, longitude;
+    double latitude = 0, longitude = 0;
     string code, name, city, countryName;
-    ifstream input(AIRPORTS);
-    if (input.is_open()) {
-        string line;
-        getline(input, line);
-        while (getline(input, line)) {
-            stringstream iss(line);
-            string token;
-            getline(iss, code, ',');
-            getline(iss, name, ',');
-            getline(iss, city, ',');
-            getline(iss, countryName, ',');
-            string latitudeStr, longitudeStr;
-            getline(iss, latitudeStr, ',');
-            getline(iss, longitudeStr, ',');
-            latitude = stod(latitudeStr);
-            longitude = stod(longitudeStr);
+    CsvReader input(AIRPORTS);
+    if (input.isOpen()) {
+        input.readRow(); // header
+        while (input.readRow()) {
+            code.assign(input.field(0));
+            name.assign(input.field(1));
+            city.assign(input.field(2));
+            countryName.assign(input.field(3));
+            if(!input.get(4, latitude) || !input.get(5, longitude)){
+                cout << "Invalid coordinates for airport " << code << endl;
+                continue;
+            }
             if(cities_.find(city + ',' + countryName) == cities_.end()){
                 cities_[city + ',' + countryName] = new City(city, countryName);
             }
@@ -107,53 +150,538 @@ void Data::read_airports() {
             if(countries_.find(countryName) == countries_.end()){
                 countries_[countryName] = new Country{countryName};
             }
-            cities_[key]->addAirport(code);
             countries_[countryName]->addCity(key);
-            airports_[code] = airport;
+            uint32_t id = airportIds_.intern(code);
+            if(id < airports_.size()){ // repeated code, the first record wins
+                delete airport;
+                continue;
+            }
+            cities_[key]->addAirport(id);
+            airports_.push_back(airport);
             airportCoord_.emplace_back(code, Coordinate(latitude, longitude));
         }
     } else {
         cout << "Could not open the file\n";
     }
 }
+namespace {
+    /** @brief The flights of one chunk of flights.csv, in file order, as a structure of arrays for the distance kernel */
+    struct FlightChunk {
+        vector<uint32_t> sources;
+        vector<uint32_t> targets;
+        vector<int32_t> airlines;   // airline id, or -1-i for the i-th airline of the chunk missing from airlines.csv
+        vector<double> dists;
+        vector<string> unknownAirlines;
+    };
+}
 /**
  * @brief Reads flight data from a file and populates relevant data structures.
- * @details Time complexity: O(N), where N is the number of entries in the flights.csv file.
+ * @details The file is loaded at once and split into newline aligned chunks, a few per thread, that are parsed in parallel:
+ * the airport and airline lookups and the Haversine distances run on every core, into one buffer of flights per chunk.
+ * The distances of a chunk are computed at once by the vectorized kernel of CoordinateBatch.
+ * The chunks are then merged in file order, so vertex adjacency and the ids given to airlines missing from airlines.csv are
+ * the same as with a serial read. Within a chunk a run of flights from the same source reuses its lookup, as flights.csv is
+ * sorted by source. Chunk boundaries assume no line break inside a quoted field.
+ * Time complexity: O(N/T + N), where N is the number of entries in the flights.csv file and T the number of threads;
+ * the serial merge only appends the parsed edges.
  */
 void Data::read_flights() {
-    string sourceCode, targetCode, airlineCode;
-    Vertex<string>* sourceVertex = nullptr;
-    string previousSource = "place-holder";
-    ifstream input(FLIGHTS);
     flightG = new Graph<string>();
-    for(auto it = airports_.begin(); it != airports_.end();it++){
-        flightG->addVertex(it->first);
-    }
-    if (input.is_open()) {
-        string line;
-        getline(input, line);
-        while (getline(input, line)) {
-            istringstream iss(line);
-            getline(iss, sourceCode, ',');
-            getline(iss, targetCode, ',');
-            getline(iss, airlineCode, ',');
-            Airport* source = airports_[sourceCode];
-            Airport* target = airports_[targetCode];
-            airline_flights[airlineCode]++;
-            double dist = source->getCoordinate().dist_coordinates(target->getCoordinate());
-            if(sourceCode != previousSource){ // tiny optimization, capitalizes on the formatting of the csv file
-                sourceVertex = flightG->findVertex(sourceCode);
-                previousSource = sourceCode;
-            }
-            Vertex<string>* destVertex = flightG->findVertex(targetCode);
-            sourceVertex->addEdge(destVertex,dist,airlineCode);
+    for(uint32_t id = 0; id < airportIds_.size(); id++){ // vertex ids follow the airport ids
+        flightG->addVertex(airportIds_.getName(id));
+    }
+    airline_flights.assign(airlines_.size(), 0);
+    vector<char> content;
+    FILE* file = fopen(FLIGHTS, "rb");
+    if(file == nullptr){
+        cout << "Could not open the file\n";
+        return;
+    }
+    char block[1 << 16];
+    for(size_t read; (read = fread(block, 1, sizeof(block), file)) > 0; ){
+        content.insert(content.end(), block, block + read);
+    }
+    fclose(file);
+    char* begin = content.data();
+    char* end = begin + content.size();
+    char* first = find(begin, end, '\n'); // skip the header
+    first = first == end ? end : first + 1;
+
+    uint32_t chunks = max<uint32_t>(1, min<size_t>(numWorkers() * 4, (end - first) / (1 << 16) + 1));
+    vector<char*> bounds(chunks + 1, end);
+    bounds[0] = first;
+    for(uint32_t c = 1; c < chunks; c++){
+        char* at = max(bounds[c - 1], first + (end - first) / chunks * c);
+        at = find(at, end, '\n');
+        bounds[c] = at == end ? end : at + 1;
+    }
+    CoordinateBatch coordinates;
+    for(auto airport : airports_){
+        coordinates.add(airport->getCoordinate());
+    }
+    vector<FlightChunk> parsed(chunks);
+    parallelFor(chunks, [&](unsigned, uint32_t c){
+        FlightChunk &chunk = parsed[c];
+        CsvReader input(bounds[c], bounds[c + 1]);
+        string code;
+        string_view previousSource;
+        int source = -1;
+        while(input.readRow()){
+            if(input.field(0) != previousSource){ // tiny optimization, capitalizes on the formatting of the csv file
+                previousSource = input.field(0);
+                code.assign(previousSource);
+                source = airportIds_.find(code);
+            }
+            code.assign(input.field(1));
+            int target = airportIds_.find(code);
+            if(source == -1 || target == -1){
+                continue;
+            }
+            code.assign(input.field(2));
+            int airline = airlineIds_.find(code);
+            if(airline == -1){ // airline missing from airlines.csv, interned during the merge
+                auto known = find(chunk.unknownAirlines.begin(), chunk.unknownAirlines.end(), code);
+                airline = -1 - (int) (known - chunk.unknownAirlines.begin());
+                if(known == chunk.unknownAirlines.end()){
+                    chunk.unknownAirlines.push_back(code);
+                }
+            }
+            chunk.sources.push_back(source);
+            chunk.targets.push_back(target);
+            chunk.airlines.push_back(airline);
+        }
+        chunk.dists.resize(chunk.sources.size());
+        coordinates.pairDistances(chunk.sources.data(), chunk.targets.data(), chunk.sources.size(), chunk.dists.data());
+    });
 
+    for(const auto &chunk : parsed){
+        vector<uint16_t> unknown;
+        for(const auto &code : chunk.unknownAirlines){
+            unknown.push_back(internAirline(code));
+        }
+        for(size_t i = 0; i < chunk.sources.size(); i++){
+            uint16_t airline = chunk.airlines[i] >= 0 ? chunk.airlines[i] : unknown[-1 - chunk.airlines[i]];
+            airline_flights[airline]++;
+            flightG->getVertex(chunk.sources[i])->addEdge(flightG->getVertex(chunk.targets[i]), chunk.dists[i], airline);
             nf++;
         }
-    } else {
-        cout << "Could not open the file\n";
+    }
+    flightG->freeze();
+    countTraffic();
+}
+/**
+ * @brief Compares the CsvReader against the previous istringstream and getline parsing on the three csv files.
+ * @details Both sides split every row into the same fields (parsing the coordinates of airports.csv) without building any
+ * object, over a few passes of each file, and the rows per second of each are printed.
+ * Time complexity: O(P*N), where P is the number of passes and N the total size of the files.
+ */
+void Data::csvReaderBenchmark() {
+    const int passes = 20;
+    const char* files[3] = {AIRLINES, AIRPORTS, FLIGHTS};
+    auto bits = [](double value){ // the exact coordinate, without a conversion that is undefined for negative values
+        uint64_t res;
+        memcpy(&res, &value, sizeof(res));
+        return res;
+    };
+    for(auto file : files){
+        uint64_t rows = 0, checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for(int pass = 0; pass < passes; pass++){
+            ifstream input(file);
+            string line, field;
+            getline(input, line);
+            while(getline(input, line)){
+                istringstream iss(line);
+                for(int i = 0; getline(iss, field, ','); i++){
+                    checksum += (i == 4 || i == 5) && file == string(AIRPORTS) ? bits(stod(field)) : field.size();
+                }
+                rows++;
+            }
+        }
+        auto middle = chrono::steady_clock::now();
+        for(int pass = 0; pass < passes; pass++){
+            CsvReader input(file);
+            input.readRow();
+            while(input.readRow()){
+                for(size_t i = 0; i < input.size(); i++){
+                    double value = 0;
+                    checksum -= (i == 4 || i == 5) && file == string(AIRPORTS) ? (input.get(i, value), bits(value)) : input.field(i).size();
+                }
+            }
+        }
+        auto end = chrono::steady_clock::now();
+        double before = chrono::duration<double>(middle - start).count(), after = chrono::duration<double>(end - middle).count();
+        cout << file << ": " << rows / passes << " rows | istringstream " << (uint64_t) (rows / before) << " rows/s | CsvReader "
+             << (uint64_t) (rows / after) << " rows/s | " << before / after << "x" << (checksum != 0 ? " (fields differ)" : "") << endl;
+    }
+}
+/**
+ * @brief Compares the vectorized Haversine kernel of CoordinateBatch against Coordinate::dist_coordinates on every flight.
+ * @details Prints the largest absolute and relative error of the kernel, the number of flights whose stored weight differs
+ * from the kernel, and the time per distance of each side. The relative error must stay well below HEURISTIC_MARGIN, the
+ * margin the A* estimate is shrunk by.
+ * Time complexity: O(V+E), where V is the number of airports and E the number of flights.
+ */
+void Data::distanceAccuracyCheck() {
+    const CSRGraph &csr = flightG->getCSR();
+    CoordinateBatch coordinates;
+    for(auto airport : airports_){
+        coordinates.add(airport->getCoordinate());
+    }
+    uint32_t n = csr.numVertices(), m = csr.numEdges();
+    vector<uint32_t> sources(m);
+    for(uint32_t v = 0; v < n; v++){
+        fill(sources.begin() + csr.begin(v), sources.begin() + csr.end(v), v);
+    }
+    vector<double> kernel(m), exact(m);
+    auto start = chrono::steady_clock::now();
+    coordinates.pairDistances(sources.data(), csr.targets.data(), m, kernel.data());
+    auto middle = chrono::steady_clock::now();
+    for(uint32_t e = 0; e < m; e++){
+        exact[e] = airports_[sources[e]]->getCoordinate().dist_coordinates(airports_[csr.targets[e]]->getCoordinate());
+    }
+    auto end = chrono::steady_clock::now();
+    double maxError = 0, maxRelative = 0;
+    uint32_t worst = 0, differing = 0;
+    for(uint32_t e = 0; e < m; e++){
+        double error = fabs(kernel[e] - exact[e]);
+        if(error > maxError){
+            maxError = error;
+            worst = e;
+        }
+        if(exact[e] > 0){
+            maxRelative = max(maxRelative, error / exact[e]);
+        }
+        differing += kernel[e] != csr.weights[e];
+    }
+    double kernelTime = chrono::duration<double, nano>(middle - start).count(), exactTime = chrono::duration<double, nano>(end - middle).count();
+    cout << "Flights: " << m << " | max error: " << maxError << " m";
+    if(m > 0){
+        cout << " (" << airportIds_.getName(sources[worst]) << " -> " << airportIds_.getName(csr.targets[worst]) << ")";
+    }
+    cout << " | max relative error: " << maxRelative << " | heuristic margin: " << HEURISTIC_MARGIN
+         << (maxRelative < HEURISTIC_MARGIN / 1000 ? "" : " (too small)") << endl;
+    cout << "Stored weights differing from the kernel: " << differing << endl;
+    cout << "Kernel: " << kernelTime / max<uint32_t>(m, 1) << " ns per distance | dist_coordinates: "
+         << exactTime / max<uint32_t>(m, 1) << " ns per distance" << endl;
+}
+/**
+ * @brief Returns the id of an airline code, registering airlines missing from airlines.csv (with no Airline object).
+ * @details Time complexity: O(1) on average
+ * @param code The airline code.
+ * @return The airline id.
+ */
+uint16_t Data::internAirline(const string &code) {
+    uint32_t airline = airlineIds_.intern(code);
+    if(airline == airlines_.size()){
+        airlines_.push_back(nullptr);
+        airline_flights.push_back(0);
+    }
+    return airline;
+}
+/**
+ * @brief Reads a batch of network updates from a csv file, in the format described in NetworkUpdate.
+ * @details Rows with an unknown action or missing fields are reported and skipped.
+ * Time complexity: O(N), where N is the number of rows of the file.
+ * @param path The file to read.
+ * @param updates Receives the updates, in file order.
+ * @return Whether the file could be opened; a missing file reads no update, so the caller does not apply an empty batch.
+ */
+bool Data::readUpdates(const string &path, vector<NetworkUpdate> &updates) {
+    CsvReader input(path);
+    if(!input.isOpen()){
+        return false;
+    }
+    int row = 0;
+    while(input.readRow()){
+        row++;
+        string_view action = input.field(0);
+        double latitude, longitude;
+        if((action == "add" || action == "cancel") && input.size() >= 4){
+            NetworkUpdate update = NetworkUpdate::addFlight(string(input.field(1)), string(input.field(2)), string(input.field(3)));
+            update.type = action == "add" ? NetworkUpdate::ADD_FLIGHT : NetworkUpdate::CANCEL_FLIGHT;
+            updates.push_back(update);
+        }
+        else if(action == "open" && input.size() >= 7 && input.get(5, latitude) && input.get(6, longitude)){
+            updates.push_back(NetworkUpdate::openAirport(string(input.field(1)), string(input.field(2)), string(input.field(3)),
+                                                         string(input.field(4)), latitude, longitude));
+        }
+        else if(action == "suspend" && input.size() >= 2){
+            updates.push_back(NetworkUpdate::suspendAirline(string(input.field(1))));
+        }
+        else if(row > 1 || action != "Action"){ // the header is optional
+            cout << "Invalid update on row " << row << endl;
+        }
+    }
+    return true;
+}
+/**
+ * @brief Applies a batch of updates to the network in place, without reading the csv files again.
+ * @details Flights are added to or removed from the adjacency of their source and counted in airline_flights and nf; opened
+ * airports get the next airport id and vertex and join the city and country indexes (creating them when new); a suspended
+ * airline loses all its flights. Updates are applied in order and invalid ones are reported and skipped. Once the batch is
+ * done the flight graph is frozen again and the traffic counters are refreshed, the contraction hierarchy, the hop matrix and
+ * the biconnected and strongly connected decompositions, which no longer match it, are dropped and the spatial index is
+ * rebuilt if airports were opened.
+ * Time complexity: O(U*d + S*E + V + E), where U is the number of updates, d the degree of their airports and S the number of suspensions.
+ * @param updates The updates.
+ * @return The number of updates applied.
+ */
+int Data::applyUpdates(const vector<NetworkUpdate> &updates) {
+    int applied = 0;
+    for(const auto &update : updates){
+        switch(update.type){
+            case NetworkUpdate::ADD_FLIGHT:
+            case NetworkUpdate::CANCEL_FLIGHT: {
+                int source = airportIds_.find(update.source), target = airportIds_.find(update.target);
+                if(source == -1 || target == -1){
+                    cout << "Airport not found: " << (source == -1 ? update.source : update.target) << endl;
+                    continue;
+                }
+                if(update.type == NetworkUpdate::ADD_FLIGHT){
+                    uint16_t airline = internAirline(update.airline);
+                    double dist = CoordinateBatch::distance(airports_[source]->getCoordinate(), airports_[target]->getCoordinate());
+                    flightG->addEdge((uint32_t) source, (uint32_t) target, dist, airline);
+                    airline_flights[airline]++;
+                    nf++;
+                }
+                else{
+                    int airline = airlineIds_.find(update.airline);
+                    if(airline == -1 || !flightG->removeEdge((uint32_t) source, (uint32_t) target, (uint16_t) airline)){
+                        cout << "Flight not found: " << update.source << " -> " << update.target << " (" << update.airline << ")" << endl;
+                        continue;
+                    }
+                    airline_flights[airline]--;
+                    nf--;
+                }
+                break;
+            }
+            case NetworkUpdate::OPEN_AIRPORT: {
+                if(airportIds_.find(update.source) != -1){
+                    cout << "Airport already exists: " << update.source << endl;
+                    continue;
+                }
+                string key = update.city + ',' + update.country;
+                if(cities_.find(key) == cities_.end()){
+                    cities_[key] = new City(update.city, update.country);
+                }
+                if(countries_.find(update.country) == countries_.end()){
+                    countries_[update.country] = new Country{update.country};
+                }
+                countries_[update.country]->addCity(key);
+                uint32_t id = airportIds_.intern(update.source);
+                airports_.push_back(new Airport(update.source, update.name, cities_[key], update.latitude, update.longitude));
+                cities_[key]->addAirport(id);
+                airportCoord_.emplace_back(update.source, Coordinate(update.latitude, update.longitude));
+                flightG->addVertex(update.source); // vertex ids follow the airport ids
+                break;
+            }
+            case NetworkUpdate::SUSPEND_AIRLINE: {
+                int airline = airlineIds_.find(update.airline);
+                if(airline == -1){
+                    cout << "Airline not found: " << update.airline << endl;
+                    continue;
+                }
+                nf -= flightG->removeEdgesOf(airline);
+                airline_flights[airline] = 0;
+                break;
+            }
+        }
+        applied++;
+    }
+    if(!flightG->isFrozen()){
+        flightG->freeze();
+        countTraffic();
+        delete ch_;
+        ch_ = nullptr;
+        delete bcc_;
+        bcc_ = nullptr;
+        delete scc_;
+        scc_ = nullptr;
+        delete hops_;
+        hops_ = nullptr;
+    }
+    if(airportIndex_.size() != airports_.size()){
+        buildAirportIndex();
+    }
+    return applied;
+}
+namespace {
+    const uint32_t SNAPSHOT_MAGIC = 0x4e454541;   // "AEEN"
+    const uint32_t SNAPSHOT_VERSION = 2;
+    const uint32_t NO_STRING = UINT32_MAX;
+}
+/**
+ * @brief Writes every table read from the csv files to a binary snapshot.
+ * @details Layout, every array aligned to 8 bytes: magic, version, the stamps of the three csv files, the interned string table,
+ * the airlines (code, name, call sign and country string ids, the last three NO_STRING for airlines missing from airlines.csv),
+ * the cities (name and country string ids), the airports (code, name and city arrays, then latitude and longitude arrays),
+ * the number of flights per airline, and the frozen flight graph (CSR offsets, targets, distances and airlines).
+ * Time complexity: O(V+E+S), where S is the total length of the strings.
+ * @param path The file to write.
+ * @return Whether the file was written.
+ */
+bool Data::saveSnapshot(const string &path) const {
+    SymbolTable strings;
+    vector<uint32_t> airlineFields;
+    for(uint32_t id = 0; id < airlines_.size(); id++){
+        Airline* airline = airlines_[id];
+        airlineFields.push_back(strings.intern(airlineIds_.getName(id)));
+        airlineFields.push_back(airline == nullptr ? NO_STRING : strings.intern(airline->getName()));
+        airlineFields.push_back(airline == nullptr ? NO_STRING : strings.intern(airline->getCallSign()));
+        airlineFields.push_back(airline == nullptr ? NO_STRING : strings.intern(airline->getCountry()));
+    }
+    vector<uint32_t> cityFields;
+    unordered_map<City*, uint32_t> cityIndex;
+    for(const auto &city : cities_){
+        cityIndex[city.second] = cityIndex.size();
+        cityFields.push_back(strings.intern(city.second->getName()));
+        cityFields.push_back(strings.intern(city.second->getCountry()));
+    }
+    vector<uint32_t> codes, names, airportCities;
+    vector<double> latitudes, longitudes;
+    for(uint32_t id = 0; id < airports_.size(); id++){
+        codes.push_back(strings.intern(airports_[id]->getCode()));
+        names.push_back(strings.intern(airports_[id]->getName()));
+        airportCities.push_back(cityIndex[airports_[id]->getCity()]);
+        latitudes.push_back(airports_[id]->getCoordinate().getLatitude());
+        longitudes.push_back(airports_[id]->getCoordinate().getLongitude());
+    }
+    vector<string> table;
+    for(uint32_t id = 0; id < strings.size(); id++){
+        table.push_back(strings.getName(id));
+    }
+    const CSRGraph &csr = flightG->getCSR();
+
+    SnapshotWriter out;
+    out.put(SNAPSHOT_MAGIC);
+    out.put(SNAPSHOT_VERSION);
+    out.put(MappedSnapshot::fileStamp(AIRLINES));
+    out.put(MappedSnapshot::fileStamp(AIRPORTS));
+    out.put(MappedSnapshot::fileStamp(FLIGHTS));
+    out.putStrings(table);
+    out.put((uint32_t) airlines_.size());
+    out.putArray(airlineFields.data(), airlineFields.size());
+    out.put((uint32_t) cities_.size());
+    out.putArray(cityFields.data(), cityFields.size());
+    out.put((uint32_t) airports_.size());
+    out.putArray(codes.data(), codes.size());
+    out.putArray(names.data(), names.size());
+    out.putArray(airportCities.data(), airportCities.size());
+    out.putArray(latitudes.data(), latitudes.size());
+    out.putArray(longitudes.data(), longitudes.size());
+    out.putArray(airline_flights.data(), airline_flights.size());
+    out.put((uint32_t) nf);
+    out.put(csr.numEdges());
+    out.putArray(csr.offsets.data(), csr.offsets.size());
+    out.putArray(csr.targets.data(), csr.targets.size());
+    out.putArray(csr.weights.data(), csr.weights.size());
+    out.putArray(csr.airlines.data(), csr.airlines.size());
+    return out.save(path);
+}
+/**
+ * @brief Loads every table from a snapshot written by saveSnapshot instead of parsing the csv files.
+ * @details The file is mapped into memory and its arrays are read in place, so loading skips the csv parsing, the hash lookups
+ * per flight and the Haversine distances. The snapshot is rejected, leaving the object untouched, if its version differs,
+ * if any csv file changed since it was written (a missing csv file is fine) or if any index is out of range.
+ * Time complexity: O(V+E+S), where S is the total length of the strings.
+ * @param path The file to read.
+ * @return Whether the snapshot was loaded.
+ */
+bool Data::loadSnapshot(const string &path) {
+    MappedSnapshot in;
+    uint32_t magic, version;
+    uint64_t stamps[3];
+    const char* files[3] = {AIRLINES, AIRPORTS, FLIGHTS};
+    if(!in.open(path) || !in.get(magic) || !in.get(version) || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION){
+        return false;
+    }
+    for(int i = 0; i < 3; i++){
+        uint64_t current = MappedSnapshot::fileStamp(files[i]);
+        if(!in.get(stamps[i]) || (current != 0 && current != stamps[i])){
+            return false;
+        }
+    }
+    vector<string> strings;
+    uint32_t numAirlines, numCities, numAirports, numFlights, numEdges;
+    const uint32_t *airlineFields, *cityFields, *codes, *names, *airportCities, *offsets, *targets;
+    const double *latitudes, *longitudes, *weights;
+    const int *flightsPerAirline;
+    const uint16_t *edgeAirlines;
+    if(!in.getStrings(strings)
+       || !in.get(numAirlines) || !(airlineFields = in.getArray<uint32_t>(4 * (size_t) numAirlines))
+       || !in.get(numCities) || !(cityFields = in.getArray<uint32_t>(2 * (size_t) numCities))
+       || !in.get(numAirports) || !(codes = in.getArray<uint32_t>(numAirports)) || !(names = in.getArray<uint32_t>(numAirports))
+       || !(airportCities = in.getArray<uint32_t>(numAirports)) || !(latitudes = in.getArray<double>(numAirports))
+       || !(longitudes = in.getArray<double>(numAirports)) || !(flightsPerAirline = in.getArray<int>(numAirlines))
+       || !in.get(numFlights) || !in.get(numEdges) || !(offsets = in.getArray<uint32_t>((size_t) numAirports + 1))
+       || !(targets = in.getArray<uint32_t>(numEdges)) || !(weights = in.getArray<double>(numEdges))
+       || !(edgeAirlines = in.getArray<uint16_t>(numEdges))){
+        return false;
+    }
+    auto validString = [&](uint32_t id){ return id < strings.size(); };
+    for(uint32_t i = 0; i < numAirlines; i++){
+        if(!validString(airlineFields[4 * i]) || (airlineFields[4 * i + 1] != NO_STRING && (!validString(airlineFields[4 * i + 1])
+           || !validString(airlineFields[4 * i + 2]) || !validString(airlineFields[4 * i + 3])))){
+            return false;
+        }
+    }
+    for(uint32_t i = 0; i < 2 * numCities; i++){
+        if(!validString(cityFields[i])){
+            return false;
+        }
+    }
+    for(uint32_t i = 0; i < numAirports; i++){
+        if(!validString(codes[i]) || !validString(names[i]) || airportCities[i] >= numCities || offsets[i] > offsets[i + 1]){
+            return false;
+        }
+    }
+    if(offsets[0] != 0 || offsets[numAirports] != numEdges){
+        return false;
+    }
+    for(uint32_t e = 0; e < numEdges; e++){
+        if(targets[e] >= numAirports || edgeAirlines[e] >= numAirlines){
+            return false;
+        }
     }
 
+    for(uint32_t i = 0; i < numAirlines; i++){
+        const uint32_t* fields = airlineFields + 4 * i;
+        airlineIds_.intern(strings[fields[0]]);
+        airlines_.push_back(fields[1] == NO_STRING ? nullptr
+                            : new Airline(strings[fields[0]], strings[fields[1]], strings[fields[2]], strings[fields[3]]));
+    }
+    vector<City*> cities;
+    for(uint32_t i = 0; i < numCities; i++){
+        const string &name = strings[cityFields[2 * i]], &countryName = strings[cityFields[2 * i + 1]];
+        string key = name + ',' + countryName;
+        City* city = new City(name, countryName);
+        cities_[key] = city;
+        cities.push_back(city);
+        if(countries_.find(countryName) == countries_.end()){
+            countries_[countryName] = new Country{countryName};
+        }
+        countries_[countryName]->addCity(key);
+    }
+    for(uint32_t id = 0; id < numAirports; id++){
+        const string &code = strings[codes[id]];
+        airportIds_.intern(code);
+        airports_.push_back(new Airport(code, strings[names[id]], cities[airportCities[id]], latitudes[id], longitudes[id]));
+        cities[airportCities[id]]->addAirport(id);
+        airportCoord_.emplace_back(code, Coordinate(latitudes[id], longitudes[id]));
+        flightG->addVertex(code);
+    }
+    airline_flights.assign(flightsPerAirline, flightsPerAirline + numAirlines);
+    nf = numFlights;
+    for(uint32_t id = 0; id < numAirports; id++){
+        Vertex<string>* vertex = flightG->getVertex(id);
+        for(uint32_t e = offsets[id]; e < offsets[id + 1]; e++){
+            vertex->addEdge(flightG->getVertex(targets[e]), weights[e], edgeAirlines[e]);
+        }
+    }
+    flightG->freeze();
+    countTraffic();
+    return true;
 }
 /**
  * @brief Lists the number of flights and airports.
@@ -171,28 +699,25 @@ void Data::listAllAirportsAndAvailableFlights() const {
  */
 void Data::flightsOutFromAirportAndDifferentAirlines(){
     string airportCode;
-    unordered_set<string> airlines;
     cout << "Airport code: ";
      cin.ignore();
      getline(cin,airportCode);
-    auto airport = flightG->findVertex(airportCode);
-    if(airport == nullptr){
+    int id = airportIds_.find(airportCode);
+    if(id == -1){
         cout << "Airport not found" << endl;
         return;
     }
-    for (auto &adj : airport->getAdj()) {
-            airlines.insert(adj.getAirline());
-    }
+    const TrafficStats &traffic = getAirportTraffic(id);
     cout << "/******************************************/" << endl;
-    cout << "Number of flights out from airport " << airports_[airportCode]->getName() << " is " << airport->getAdj().size() << endl;
-    cout << "Number of unique airlines are " << airlines.size() << endl;
+    cout << "Number of flights out from airport " << airports_[id]->getName() << " is " << traffic.flightsOut << endl;
+    cout << "Number of unique airlines are " << traffic.airlines << endl;
     cout << "/******************************************/" << endl;
 }
 
 /**
  * @brief Calculates the number of unique countries reachable from a given airport or city.
  * @param airport_city The mode of calculation ("airport" or "city").
- * @details Time complexity: O(N), where N is the number of destinations from the specified airport or city.
+ * @details Time complexity: O(1) on average, a lookup in the traffic tables.
  */
 void Data::numberOfUniqueCountriesReachableAirport_City(string airport_city) { // keep in mind that if u are in the country and u can access it via city/airport it will count as part of the sum
     if(airport_city == "airport"){
@@ -200,19 +725,13 @@ void Data::numberOfUniqueCountriesReachableAirport_City(string airport_city) { /
         cout << "Airport code: ";
         cin.ignore();
         getline(cin,airportCode);
-        auto it = airports_.find(airportCode);
-        if (it == airports_.end()) {
+        int id = airportIds_.find(airportCode);
+        if (id == -1) {
             cout << "Airport not found" << endl;
             return;
         }
-        unordered_set<string> countries;
-        for(auto &adj : flightG->findVertex(airportCode)->getAdj()){
-            auto airportDestiny = adj.getDest()->getInfo();
-            auto country = airports_[airportDestiny]->getCity()->getCountry();
-            countries.insert(country);
-        }
         cout << "/******************************************/" << endl;
-        cout << "Number of unique countries reachable from airport " << airportCode << " is " << countries.size() << endl;
+        cout << "Number of unique countries reachable from airport " << airportCode << " is " << getAirportTraffic(id).countries << endl;
         cout << "/******************************************/" << endl;
     }
     else{
@@ -220,8 +739,8 @@ void Data::numberOfUniqueCountriesReachableAirport_City(string airport_city) { /
         cout << "Choose a city and its country (ex: Porto,Portugal):";
         cin.ignore();
         getline(cin,city_country);
-        auto it = cities_.find(city_country);
-        if (it == cities_.end()) {
+        const TrafficStats *traffic = getCityTraffic(city_country);
+        if (traffic == nullptr) {
             cout << "City not found" << endl;
             return;
         }
@@ -229,24 +748,15 @@ void Data::numberOfUniqueCountriesReachableAirport_City(string airport_city) { /
         string city, country;
         getline(iss, city, ',');
         getline(iss, country);
-        auto cityObj = it->second;
-        unordered_set<string> countries;
-        for(auto &airport : cityObj->getAirports()){
-            for(auto &adj : flightG->findVertex(airport)->getAdj()){
-                auto airportDestiny = adj.getDest()->getInfo();
-                auto destinyCountry = airports_[airportDestiny]->getCity()->getCountry();
-                countries.insert(destinyCountry);
-            }
-        }
         cout << "/******************************************/" << endl;
-        cout << "Number of unique countries reachable from city " << city << " in " << country << " is " << countries.size() << endl;
+        cout << "Number of unique countries reachable from city " << city << " in " << country << " is " << traffic->countries << endl;
         cout << "/******************************************/" << endl;
     }
 }
 /**
- * @brief Calculates the number of flights in a specific city or by a particular airline.
- * @param city_airline The mode of calculation ("city" or "airline").
- * @details Time complexity: O(N), where N is the number of flights associated with the specified city or airline.
+ * @brief Calculates the number of flights in a specific city or country or by a particular airline.
+ * @param city_airline The mode of calculation ("city", "country" or "airline").
+ * @details Time complexity: O(1) on average, a lookup in the traffic tables.
  */
 void Data::numberOfFlightsPerCity_Airline(string city_airline) {
     if (city_airline == "city") {
@@ -254,8 +764,8 @@ void Data::numberOfFlightsPerCity_Airline(string city_airline) {
         string city_country;
         cin.ignore();
         getline(std::cin,city_country);
-        auto it = cities_.find(city_country);
-        if (it == cities_.end()) {
+        const TrafficStats *traffic = getCityTraffic(city_country);
+        if (traffic == nullptr) {
             cout << "City not found" << endl;
             return;
         }
@@ -263,13 +773,24 @@ void Data::numberOfFlightsPerCity_Airline(string city_airline) {
         string city, country;
         getline(iss, city, ',');
         getline(iss, country);
-        auto cityObj = it->second;
-        int nFlights = 0;
-        for (auto &airport : cityObj->getAirports()) {
-            nFlights += flightG->findVertex(airport)->getAdj().size();
+        cout << "/******************************************/" << endl;
+        cout << "Number of flights in the city of " << city << " in " << country << " is "<< traffic->flightsOut << endl;
+        cout << "/******************************************/" << endl;
+    }
+    else if (city_airline == "country") {
+        cout << "Choose a country: ";
+        string country;
+        cin.ignore();
+        getline(cin,country);
+        const TrafficStats *traffic = getCountryTraffic(country);
+        if (traffic == nullptr) {
+            cout << "Country not found" << endl;
+            return;
         }
         cout << "/******************************************/" << endl;
-        cout << "Number of flights in the city of " << city << " in " << country << " is "<< nFlights << endl;
+        cout << "Number of flights in " << country << " is " << traffic->flightsOut << endl;
+        cout << "Number of unique airlines flying out of " << country << " is " << traffic->airlines << endl;
+        cout << "Number of unique countries reachable from " << country << " is " << traffic->countries << endl;
         cout << "/******************************************/" << endl;
     }
     else{
@@ -277,13 +798,13 @@ void Data::numberOfFlightsPerCity_Airline(string city_airline) {
         cout << "Choose an airline: ";
         cin.ignore();
         getline(cin,airline);
-        auto it = airlines_.find(airline);
-        if (it == airlines_.end()){
+        int id = airlineIds_.find(airline);
+        if (id == -1){
             cout << "Airline not found" << endl;
             return;
         }
         cout << "/******************************************/" << endl;
-        cout << "Number of flights of "<< airline <<" airline" << " is " << airline_flights[airline] << endl;
+        cout << "Number of flights of "<< airline <<" airline" << " is " << airline_flights[id] << endl;
         cout << "/******************************************/" << endl;
     }
 
@@ -291,16 +812,16 @@ void Data::numberOfFlightsPerCity_Airline(string city_airline) {
 
 /**
  * @brief Finds the best flight options between source and destination with specific constraints.
- * @param sourceMode The mode for specifying the source ("airportCode", "airportName", "cityName", "geoCoords").
+ * @param sourceMode The mode for specifying the source ("airportCode", "airportName", "cityName", "geoCoords", "geoRadius", "geoNearest"); see getFilteredVertex.
  * @param source The source identifier.
- * @param destMode The mode for specifying the destination ("airportCode", "airportName", "cityName", "geoCoords").
+ * @param destMode The mode for specifying the destination ("airportCode", "airportName", "cityName", "geoCoords", "geoRadius", "geoNearest"); see getFilteredVertex.
  * @param dest The destination identifier.
- * @param allowed The unordered set of allowed airlines.
+ * @param allowed The allowed airlines.
  * @param min If true, minimizes the number of airlines used.
  * @details Time complexity: O(N log N), where N is the total number of flights in the flights.csv file.
  */
 
-void Data::bestFlightOption(string sourceMode,string source,string destMode, string dest,unordered_set<string> allowed, bool min){
+void Data::bestFlightOption(string sourceMode,string source,string destMode, string dest,const AirlineFilter &allowed, bool min){
     vector<Vertex<string>*> sourceNodes = getFilteredVertex(sourceMode,source);
     if(sourceNodes.size() == 0){
         cout << "No source airports found" << endl;
@@ -319,31 +840,395 @@ void Data::bestFlightOption(string sourceMode,string source,string destMode, str
 
     }
 }
+/**
+ * @brief Finds and prints the shortest trip, in flown distance, between the locations specified by the user.
+ * @param sourceMode The mode for specifying the source ("airportCode", "airportName", "cityName", "geoCoords", "geoRadius", "geoNearest"); see getFilteredVertex.
+ * @param source The source identifier.
+ * @param destMode The mode for specifying the destination ("airportCode", "airportName", "cityName", "geoCoords", "geoRadius", "geoNearest"); see getFilteredVertex.
+ * @param dest The destination identifier.
+ * @param allowed The allowed airlines.
+ * @param algorithm "dijkstra", "astar" (Dijkstra guided by the great-circle heuristic) or "ch" (contraction hierarchy).
+ * The contraction hierarchy ignores airlines, so with an airline filter "ch" falls back to A*.
+ * @details Time complexity: O((V+E) log V), see shortestDistance; much less with "ch".
+ */
+void Data::shortestDistanceOption(string sourceMode, string source, string destMode, string dest, const AirlineFilter &allowed,
+                                  string algorithm) {
+    vector<Vertex<string>*> sourceNodes = getFilteredVertex(sourceMode,source);
+    if(sourceNodes.size() == 0){
+        cout << "No source airports found" << endl;
+        return;
+    }
+    vector<Vertex<string>*> destNodes = getFilteredVertex(destMode,dest);
+    if(destNodes.size() == 0){
+        cout << "No destination nodes found" <<endl;
+        return;
+    }
+    vector<uint32_t> sources, targets;
+    for(auto vertex : sourceNodes){
+        sources.push_back(vertex->getId());
+    }
+    for(auto vertex : destNodes){
+        targets.push_back(vertex->getId());
+    }
+    if(algorithm == "ch" && !allowed.allowsAll()){
+        cout << "The contraction hierarchy covers every airline, using A* instead" << endl;
+        algorithm = "astar";
+    }
+    vector<pair<uint32_t, uint16_t>> route;
+    uint32_t settled = 0;
+    double distance;
+    if(algorithm == "ch"){
+        distance = getContractionHierarchy().query(sources,targets,route,settled);
+    }
+    else{
+        distance = shortestDistance(sources,targets,allowed,algorithm == "astar",route,settled);
+    }
+    if(distance < 0){
+        cout << "No trip found" << endl;
+    }
+    else{
+        cout << airportIds_.getName(route[0].first);
+        for(size_t i = 1; i < route.size(); i++){
+            cout << " -(" << airlineIds_.getName(route[i].second) << ")-> " << airportIds_.getName(route[i].first);
+        }
+        cout << endl << "Distance: " << distance / 1000 << " km | " << route.size() << " airports visited" << endl;
+    }
+    cout << (algorithm == "ch" ? "Contraction hierarchy" : algorithm == "astar" ? "A*" : "Dijkstra") << " settled " << settled << " airports" << endl;
+}
+/**
+ * @brief Getter for the biconnected decomposition of the flight graph, computed on the first call and dropped when the network changes.
+ * @details Time complexity: O(V+E log d) on the first call, O(1) afterwards.
+ * @return The articulation points, bridges and biconnected components.
+ */
+BiconnectedComponents &Data::getBiconnectedComponents() {
+    if(bcc_ == nullptr){
+        bcc_ = new BiconnectedComponents();
+        bcc_->build(flightG->getCSR());
+    }
+    return *bcc_;
+}
+/**
+ * @brief Getter for the strongly connected decomposition of the flight graph, computed on the first call and dropped when the network changes.
+ * @details Also counts the cities and countries reachable from every component, so that reachability queries are lookups.
+ * Time complexity: O(V+E log d+C*(V+Ci+Co)/64) on the first call, where C is the number of components, Ci of cities and Co of countries, O(1) afterwards.
+ * @return The components and their condensation DAG.
+ */
+StronglyConnectedComponents &Data::getStronglyConnectedComponents() {
+    if(scc_ == nullptr){
+        scc_ = new StronglyConnectedComponents();
+        scc_->build(flightG->getCSR());
+        vector<uint32_t> cityOf, countryOf;
+        uint32_t numCities, numCountries;
+        locationIds(cityOf, numCities, countryOf, numCountries);
+        cityReach_ = scc_->reachableLabels(cityOf, numCities);
+        countryReach_ = scc_->reachableLabels(countryOf, numCountries);
+    }
+    return *scc_;
+}
+/**
+ * @brief Getter for the hop matrix of the flight graph.
+ * @details The first call loads it from HOP_MATRIX, or builds it and saves it there when the file is missing or was built
+ * from another network.
+ * Time complexity: O(V²) to load, O(V*D*(V+E)/(64*P) + V²) to build, where D is the diameter and P the number of threads, O(1) afterwards.
+ * @return The number of flights between every pair of airports.
+ */
+HopMatrix &Data::getHopMatrix() {
+    if(hops_ == nullptr){
+        hops_ = new HopMatrix();
+        if(!hops_->load(HOP_MATRIX, ContractionHierarchy::fingerprint(flightG->getCSR()))){
+            hops_->build(flightG->getCSR());
+            if(!hops_->save(HOP_MATRIX)){
+                cout << "Could not save the hop matrix" << endl;
+            }
+        }
+    }
+    return *hops_;
+}
+/**
+ * @brief Getter for the contraction hierarchy of the flight graph.
+ * @details The first call loads it from CONTRACTION_HIERARCHY, or builds it and saves it there when the file is missing
+ * or was built from different flights, so only the first run after the csv files change pays for the contraction.
+ * Time complexity: O(V+A) to load, where A is the number of arcs of the hierarchy; O(1) after the first call.
+ * @return The contraction hierarchy.
+ */
+ContractionHierarchy &Data::getContractionHierarchy() {
+    if(ch_ == nullptr){
+        ch_ = new ContractionHierarchy();
+        if(!ch_->load(CONTRACTION_HIERARCHY, ContractionHierarchy::fingerprint(flightG->getCSR()))){
+            cout << "Building the contraction hierarchy..." << endl;
+            ch_->build(flightG->getCSR());
+            if(!ch_->save(CONTRACTION_HIERARCHY)){
+                cout << "Could not save the contraction hierarchy" << endl;
+            }
+        }
+    }
+    return *ch_;
+}
+/**
+ * @brief Compares the contraction hierarchy against plain Dijkstra on random pairs of airports from airports.csv.
+ * @details Both answer the same pairs, drawn with a fixed seed so runs are comparable; the average query time, the number of
+ * settled airports and any pair where the distances disagree are printed.
+ * Time complexity: O(P*(V+E) log V), where P is the number of pairs.
+ * @param pairs The number of random pairs.
+ */
+void Data::shortestDistanceBenchmark(int pairs) {
+    ContractionHierarchy &ch = getContractionHierarchy();
+    AirlineFilter all = AirlineFilter::allAirlines();
+    mt19937 random(2023);
+    uniform_int_distribution<uint32_t> pick(0, airports_.size() - 1);
+    vector<pair<uint32_t, uint16_t>> route;
+    double dijkstraTime = 0, chTime = 0;
+    uint64_t dijkstraSettled = 0, chSettled = 0;
+    int mismatches = 0;
+    for(int i = 0; i < pairs; i++){
+        vector<uint32_t> source = {pick(random)}, target = {pick(random)};
+        uint32_t settled;
+        auto start = chrono::steady_clock::now();
+        double expected = shortestDistance(source,target,all,false,route,settled);
+        auto middle = chrono::steady_clock::now();
+        dijkstraSettled += settled;
+        double distance = ch.query(source,target,route,settled);
+        auto end = chrono::steady_clock::now();
+        chSettled += settled;
+        dijkstraTime += chrono::duration<double, micro>(middle - start).count();
+        chTime += chrono::duration<double, micro>(end - middle).count();
+        if(abs(expected - distance) > 1e-6 * max(1.0, abs(expected))){
+            mismatches++;
+            cout << "Mismatch " << airportIds_.getName(source[0]) << " -> " << airportIds_.getName(target[0]) << ": "
+                 << expected << " vs " << distance << endl;
+        }
+    }
+    cout << "Pairs: " << pairs << " | hierarchy arcs: " << ch.numArcs() << endl;
+    cout << "Dijkstra: " << dijkstraTime / pairs << " us per query, " << (double) dijkstraSettled / pairs << " airports settled" << endl;
+    cout << "Contraction hierarchy: " << chTime / pairs << " us per query, " << (double) chSettled / pairs << " airports settled" << endl;
+    cout << "Speedup: " << dijkstraTime / max(chTime, 1e-9) << "x | mismatches: " << mismatches << endl;
+}
+/**
+ * @brief Shortest trip, by the great-circle distance of its flights, from any of the sources to any of the targets.
+ * @details Dijkstra over the frozen flight graph with an indexed 4-ary heap, stopping as soon as a target is settled.
+ * With heuristic the keys become distance + the great-circle distance to the closest target (A*), computed with the same
+ * CoordinateBatch kernel as the flight weights and shrunk by HEURISTIC_MARGIN; no sequence of flights is shorter than the
+ * direct arc, so the estimate is consistent: every flight is at least as long as the difference of the estimates of its
+ * airports, so every airport is still settled at most once
+ * and the search is pulled towards the targets instead of growing as a circle around the sources.
+ * @param sources The ids of the airports the trip may start at.
+ * @param targets The ids of the airports the trip may end at.
+ * @param allowed The allowed airline ids.
+ * @param heuristic Whether to use the great-circle heuristic (A*).
+ * @param route Filled with the airports of the trip and the airline of the flight into each of them (the first one has NO_AIRLINE).
+ * @param settled Set to the number of airports settled by the search.
+ * @return The length of the trip in meters, or -1 if no target is reachable.
+ * @details Time complexity: O((V+E) log V), where V is the number of airports and E the number of flights.
+ */
+double Data::shortestDistance(const vector<uint32_t> &sources, const vector<uint32_t> &targets, const AirlineFilter &allowed,
+                              bool heuristic, vector<pair<uint32_t, uint16_t>> &route, uint32_t &settled) {
+    const CSRGraph &csr = flightG->getCSR();
+    uint32_t n = csr.numVertices();
+    bool all = allowed.allowsAll();
+    traversal_.reset(n);
+    routeHeap_.reset(n);
+    if(routeDist_.size() < n){
+        routeDist_.resize(n);
+        routeEstimate_.resize(n);
+        routeParent_.resize(n);
+    }
+    CoordinateBatch targetCoords;
+    if(heuristic){
+        for(auto target : targets){
+            targetCoords.add(airports_[target]->getCoordinate());
+        }
+    }
+    vector<double> targetDists(targetCoords.size());
+    // the flights are weighted by the same kernel, the margin absorbs its rounding in the triangle inequality
+    auto estimate = [&](uint32_t v){
+        if(targetDists.empty()){
+            return 0.0;
+        }
+        targetCoords.distancesFrom(airports_[v]->getCoordinate(), targetDists.data());
+        return *min_element(targetDists.begin(), targetDists.end()) * (1 - HEURISTIC_MARGIN);
+    };
+    auto discover = [&](uint32_t v, double dist, uint32_t parent, uint16_t airline){
+        if(!traversal_.isVisited(v)){
+            traversal_.visit(v, 0);
+            routeEstimate_[v] = heuristic ? estimate(v) : 0;
+        }
+        else if(dist >= routeDist_[v]){
+            return;
+        }
+        routeDist_[v] = dist;
+        routeParent_[v] = {parent, airline};
+        routeHeap_.pushOrDecrease(v, dist + routeEstimate_[v]);
+    };
+    for(auto source : sources){
+        discover(source, 0, source, NO_AIRLINE);
+    }
+    route.clear();
+    settled = 0;
+    while(!routeHeap_.empty()){
+        uint32_t u = routeHeap_.pop();
+        traversal_.setProcessing(u, true); // settled
+        settled++;
+        if(find(targets.begin(), targets.end(), u) != targets.end()){
+            for(uint32_t v = u; ; v = routeParent_[v].first){
+                route.push_back({v, routeParent_[v].second});
+                if(routeParent_[v].first == v){
+                    break;
+                }
+            }
+            reverse(route.begin(), route.end());
+            return routeDist_[u];
+        }
+        for(uint32_t e = csr.begin(u); e < csr.end(u); e++){
+            uint32_t v = csr.targets[e];
+            if(traversal_.isProcessing(v) || (!all && !allowed.allows(csr.airlines[e]))){
+                continue;
+            }
+            discover(v, routeDist_[u] + csr.weights[e], u, csr.airlines[e]);
+        }
+    }
+    return -1;
+}
+/**
+ * @brief Builds the spatial index over the coordinates of the airports, indexed by airport id.
+ * @details Time complexity: O(V log V), where V is the number of airports.
+ */
+void Data::buildAirportIndex(){
+    vector<Coordinate> coordinates;
+    coordinates.reserve(airports_.size());
+    for(auto airport : airports_){
+        coordinates.push_back(airport->getCoordinate());
+    }
+    airportIndex_.build(coordinates);
+}
+/**
+ * @brief Finds the k airports closest to a location, the catchment of a trip that may start at any of them.
+ * @details Time complexity: O(k log k + log V) on average, where V is the number of airports.
+ * @param center The location.
+ * @param k The number of airports.
+ * @return The great-circle distance in meters and the id of every airport found, closest first.
+ */
+vector<pair<double, uint32_t>> Data::nearestAirports(const Coordinate &center, uint32_t k) const {
+    vector<pair<double, uint32_t>> res;
+    airportIndex_.nearest(center, k, res);
+    return res;
+}
+/**
+ * @brief Finds every airport within a great-circle distance of a location, the catchment of a trip that may start at any of them.
+ * @details Time complexity: O(m log m + log V) on average, where m is the number of airports found and V the number of airports.
+ * @param center The location.
+ * @param radius The distance, in meters.
+ * @return The great-circle distance in meters and the id of every airport found, closest first.
+ */
+vector<pair<double, uint32_t>> Data::airportsWithinRadius(const Coordinate &center, double radius) const {
+    vector<pair<double, uint32_t>> res;
+    airportIndex_.withinRadius(center, radius, res);
+    return res;
+}
+/**
+ * @brief Times the catchment queries of the spatial index against a linear scan of the airports with dist_coordinates.
+ * @details Random locations with a fixed seed, each with a radius between 50 and 500 km and the 10 nearest airports;
+ * the airports found by both sides are compared.
+ * Time complexity: O(Q*V), where Q is the number of queries and V the number of airports.
+ * @param queries The number of locations.
+ */
+void Data::catchmentBenchmark(int queries) {
+    const uint32_t k = 10;
+    mt19937 random(2023);
+    uniform_real_distribution<double> latitude(-60, 70), longitude(-180, 180), radius(50000, 500000);
+    double scanTime = 0, indexTime = 0;
+    uint64_t found = 0;
+    int mismatches = 0;
+    vector<pair<double, uint32_t>> scanned;
+    for(int i = 0; i < queries; i++){
+        Coordinate center(latitude(random), longitude(random));
+        double r = radius(random);
+        auto start = chrono::steady_clock::now();
+        scanned.clear();
+        for(uint32_t id = 0; id < airports_.size(); id++){
+            scanned.emplace_back(center.dist_coordinates(airports_[id]->getCoordinate()), id);
+        }
+        vector<uint32_t> scanRadius, scanNearest;
+        for(const auto &airport : scanned){
+            if(airport.first <= r){
+                scanRadius.push_back(airport.second);
+            }
+        }
+        uint32_t kept = min<size_t>(k, scanned.size());
+        partial_sort(scanned.begin(), scanned.begin() + kept, scanned.end());
+        for(uint32_t j = 0; j < kept; j++){
+            scanNearest.push_back(scanned[j].second);
+        }
+        auto middle = chrono::steady_clock::now();
+        vector<pair<double, uint32_t>> withinRadius = airportsWithinRadius(center, r);
+        vector<pair<double, uint32_t>> nearest = nearestAirports(center, k);
+        auto end = chrono::steady_clock::now();
+        scanTime += chrono::duration<double, micro>(middle - start).count();
+        indexTime += chrono::duration<double, micro>(end - middle).count();
+        found += withinRadius.size();
+        vector<uint32_t> indexRadius, indexNearest;
+        for(const auto &airport : withinRadius){
+            indexRadius.push_back(airport.second);
+        }
+        for(const auto &airport : nearest){
+            indexNearest.push_back(airport.second);
+        }
+        sort(scanRadius.begin(), scanRadius.end());
+        sort(indexRadius.begin(), indexRadius.end());
+        if(scanRadius != indexRadius || scanNearest != indexNearest){
+            mismatches++;
+        }
+    }
+    cout << "Locations: " << queries << " | airports per radius query: " << (double) found / queries << endl;
+    cout << "Linear scan: " << scanTime / queries << " us per radius and nearest query" << endl;
+    cout << "Spatial index: " << indexTime / queries << " us per radius and nearest query" << endl;
+    cout << "Speedup: " << scanTime / max(indexTime, 1e-9) << "x | mismatches: " << mismatches << endl;
+}
+/**
+ * @brief Lists the k airports closest to a location, with their great-circle distance to it.
+ * @details Time complexity: O(k log k + log V) on average, where V is the number of airports.
+ * @param coordinate The location.
+ * @param k The number of airports to list.
+ */
+void Data::listNearestAirports(const Coordinate &coordinate, int k) const {
+    vector<pair<double, uint32_t>> nearest = nearestAirports(coordinate, k > 0 ? k : 0);
+    cout << "/******************************************/" << endl;
+    for(const auto &airport : nearest){
+        Airport* a = airports_[airport.second];
+        cout << a->getCode() << " - " << a->getName() << " (" << a->getCity()->getName() << ", "
+             << a->getCity()->getCountry() << "): " << fixed << setprecision(1) << airport.first / 1000 << " km" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << "/******************************************/" << endl;
+}
 /**
  * @brief Retrieves a filtered list of vertices based on the specified mode and search term.
- * @param mode The filter mode, which can be "airportCode," "airportName," "cityName," or "geoCoords."
- * @param searchTerm The term to search for based on the specified mode.
+ * @param mode The filter mode, which can be "airportCode," "airportName," "cityName," "geoCoords," "geoRadius" or "geoNearest."
+ * @param searchTerm The term to search for based on the specified mode: "latitude,longitude" for "geoCoords",
+ * "latitude,longitude,km" for the airports within that distance ("geoRadius") and "latitude,longitude,k" for the k nearest airports ("geoNearest").
  * @return A vector of Vertex pointers representing the filtered vertices.
- * @details Time complexity: O(N), where N is the number of vertices in the flight graph.
+ * @details The airports near geographical coordinates come from the spatial index.
+ * Time complexity: O(N) for airport names, O(log N) on average for coordinates, where N is the number of vertices in the flight graph.
  */
 vector<Vertex<string>*> Data:: getFilteredVertex(string mode,string searchTerm){
     vector<Vertex<string>*> res;
     if(mode == "airportCode"){
-        res.push_back(flightG->findVertex(searchTerm));
-
+        int id = airportIds_.find(searchTerm);
+        if(id != -1){
+            res.push_back(flightG->getVertex(id));
+        }
     }
     if(mode == "airportName"){
-        for( auto entry: airports_){
-            if(entry.second->getName() == searchTerm){
-                res.push_back(flightG->findVertex(entry.second->getCode()));
+        for(uint32_t id = 0; id < airports_.size(); id++){
+            if(airports_[id]->getName() == searchTerm){
+                res.push_back(flightG->getVertex(id));
             }
         }
     }
     if(mode == "cityName"){
-        for(auto entry : airports_){
-            string compareString = entry.second->getCity()->getName() + "," +entry.second->getCity()->getCountry();
-            if(compareString == searchTerm){
-                res.push_back(flightG->findVertex(entry.second->getCode())); // might change depend on the teacher's answer
+        auto city = cities_.find(searchTerm);
+        if(city != cities_.end()){
+            for(auto id : city->second->getAirports()){
+                res.push_back(flightG->getVertex(id)); // might change depend on the teacher's answer
             }
         }
     }
@@ -354,19 +1239,38 @@ vector<Vertex<string>*> Data:: getFilteredVertex(string mode,string searchTerm){
         getline(coords,latitudeStr,',');
         getline(coords,longitudeStr,',');
         Coordinate coordinate(stod(latitudeStr), stod(longitudeStr ));
-        double minDistance = numeric_limits<double>::max();
-        for(auto entry:airports_){
-            double distance = coordinate.dist_coordinates(entry.second->getCoordinate());
-            if(distance < minDistance){
-                res.clear();
-                res.push_back(flightG->findVertex(entry.second->getCode()));
-                minDistance = distance;
+        vector<pair<double, uint32_t>> nearest;
+        airportIndex_.nearest(coordinate, 1, nearest);
+        if(!nearest.empty()){ // airports tied with the nearest one, settled with the exact distance
+            airportIndex_.withinRadius(coordinate, nearest[0].first + 1, nearest);
+            double minDistance = numeric_limits<double>::max();
+            for(auto &candidate : nearest){
+                candidate.first = coordinate.dist_coordinates(airports_[candidate.second]->getCoordinate());
+                minDistance = min(minDistance, candidate.first);
             }
-            if(distance == minDistance){
-                res.push_back(flightG->findVertex(entry.second->getCode()));
+            sort(nearest.begin(), nearest.end(), [](const pair<double, uint32_t> &a, const pair<double, uint32_t> &b){
+                return a.second < b.second;
+            });
+            for(const auto &candidate : nearest){
+                if(candidate.first == minDistance){
+                    res.push_back(flightG->getVertex(candidate.second));
+                }
             }
         }
-
+    }
+    if(mode == "geoRadius" || mode == "geoNearest"){
+        istringstream coords(searchTerm);
+        string latitudeStr, longitudeStr, amountStr;
+        getline(coords,latitudeStr,',');
+        getline(coords,longitudeStr,',');
+        getline(coords,amountStr,',');
+        Coordinate coordinate(stod(latitudeStr), stod(longitudeStr));
+        double amount = stod(amountStr);
+        vector<pair<double, uint32_t>> catchment = mode == "geoRadius" ? airportsWithinRadius(coordinate, amount * 1000)
+                                                                       : nearestAirports(coordinate, amount > 0 ? (uint32_t) amount : 0);
+        for(const auto &airport : catchment){
+            res.push_back(flightG->getVertex(airport.second));
+        }
     }
     return res;
 }
@@ -375,26 +1279,69 @@ vector<Vertex<string>*> Data:: getFilteredVertex(string mode,string searchTerm){
  * @brief Finds the best flight options from a set of source airports to a set of destination airports.
  * @param source A vector of Vertex pointers representing the source airports.
  * @param dest A vector of Vertex pointers representing the destination airports.
- * @param allowed A unordered set of strings representing the allowed airlines.
- * @details Time complexity: O(S*(V+E)), where S is the number of vertices in the source vector, V is the total number of vertices in the flight graph and E is the total number of edges in the graph.
+ * @param allowed The allowed airlines.
+ * @details A single pair is searched from both ends at once. Otherwise one BFS starts from every source at distance 0 and stops
+ * at the first layer holding a target, and the trips of all the optimal (source, target) pairs are unpacked together, walking
+ * back from those targets through airports one flight closer to the sources.
+ * Time complexity: O(V+E+P*L), where V is the total number of vertices in the flight graph, E is the total number of edges in the graph,
+ * P the number of optimal trips and L their length.
  */
 
-void Data:: bestFlightOption(vector<Vertex<string>*> source, vector<Vertex<string>*> dest, const unordered_set<string>& allowed){
+void Data:: bestFlightOption(vector<Vertex<string>*> source, vector<Vertex<string>*> dest, const AirlineFilter &allowed){
 
     vector<vector<string>> pathsDiscovered;
-    vector<string> path;
-    for(auto sourceVertex: source){
-        bfsBestFlightOption(sourceVertex,allowed);
-        Graph<string> reverse = getReverseGraph();
-        Vertex<string>* reverseSource = reverse.findVertex(sourceVertex->getInfo());
-        for(auto destVertex: dest){
-            Vertex<string>* reverseDest = reverse.findVertex(destVertex->getInfo());
-            reverseDfsBestFlightOption(reverseDest,reverseSource,pathsDiscovered,path);
+    if(source.size() == 1 && dest.size() == 1){ // point to point, both searches meet half way
+        vector<uint32_t> meeting;
+        if(bidirectionalBfs(source[0]->getId(),dest[0]->getId(),allowed,traversal_,reverseTraversal_,meeting) != -1){
+            for(auto meet : meeting){
+                vector<vector<uint32_t>> prefixes, suffixes;
+                vector<uint32_t> half;
+                halfPathsFromMeeting(meet,traversal_,false,allowed,half,prefixes);
+                halfPathsFromMeeting(meet,reverseTraversal_,true,allowed,half,suffixes);
+                for(const auto &prefix : prefixes){
+                    for(const auto &suffix : suffixes){
+                        vector<string> codes;
+                        for(auto it = prefix.rbegin(); it != prefix.rend(); it++){
+                            codes.push_back(airportIds_.getName(*it));
+                        }
+                        for(size_t i = 1; i < suffix.size(); i++){
+                            codes.push_back(airportIds_.getName(suffix[i]));
+                        }
+                        pathsDiscovered.push_back(codes);
+                    }
+                }
+            }
+        }
+    }
+    else{ // every source at distance 0, every optimal trip ends at a target of the first layer reached
+        vector<uint32_t> sources, targets;
+        for(auto vertex : source){
+            sources.push_back(vertex->getId());
+        }
+        for(auto vertex : dest){
+            targets.push_back(vertex->getId());
+        }
+        int hops = multiSourceBfs(sources,targets,allowed,traversal_);
+        sort(targets.begin(),targets.end());
+        targets.erase(unique(targets.begin(),targets.end()),targets.end());
+        for(auto target : targets){
+            if(hops == -1 || traversal_.getDist(target) != hops){
+                continue;
+            }
+            vector<vector<uint32_t>> trips;
+            vector<uint32_t> half;
+            halfPathsFromMeeting(target,traversal_,false,allowed,half,trips);
+            for(const auto &trip : trips){
+                vector<string> codes;
+                for(auto it = trip.rbegin(); it != trip.rend(); it++){
+                    codes.push_back(airportIds_.getName(*it));
+                }
+                pathsDiscovered.push_back(codes);
+            }
         }
     }
-    fiterForSmallest(pathsDiscovered);
     cout << "Number of paths found: " << pathsDiscovered.size() << endl;
-    for(auto currentPath:pathsDiscovered){
+    for(const auto &currentPath:pathsDiscovered){
         for(auto airport: currentPath){
             cout << airport << " -> ";
         }
@@ -405,172 +1352,148 @@ void Data:: bestFlightOption(vector<Vertex<string>*> source, vector<Vertex<strin
 
 
 /**
- * @brief Using bfs, calculates the distance between the source vertex and every other vertex.
- * @param source
- * @param dest
- * @param allowed
- * @details Time complexity: O(V+E), where V is the total number of vertices in the flight graph and E is the total number of edges in the graph.
+ * @brief Bidirectional bfs between two airports, flying only the allowed airlines.
+ * @details The search expands one full layer at a time from whichever side has the smaller frontier, over the outgoing edges
+ * from the source and over the incoming edges towards the target, and stops at the first layer where both searches meet.
+ * At that point every shortest trip crosses exactly one meeting vertex.
+ * @param source The id of the source airport.
+ * @param target The id of the target airport.
+ * @param allowed The allowed airline ids.
+ * @param forward Ends up holding the distance from source of every vertex reached by the forward search.
+ * @param backward Ends up holding the distance to target of every vertex reached by the backward search.
+ * @param meeting Filled with the vertices where both searches meet.
+ * @return The number of flights of the shortest trips, or -1 if target is not reachable.
+ * @details Time complexity: O(V+E) in the worst case, usually a small fraction of the graph around both airports.
  */
-void Data::bfsBestFlightOption(Vertex<string>* source, unordered_set<string> allowed){
-    for( auto v: flightG->getVertexSet()){
-        v.second->setVisited(false);
-        v.second->setNum(INT_MAX);
+int Data::bidirectionalBfs(uint32_t source, uint32_t target, const AirlineFilter &allowed, TraversalContext &forward,
+                           TraversalContext &backward, vector<uint32_t> &meeting) {
+    const CSRGraph &csr = flightG->getCSR();
+    bool all = allowed.allowsAll();
+    forward.reset(csr.numVertices());
+    backward.reset(csr.numVertices());
+    forward.visit(source, 0);
+    backward.visit(target, 0);
+    meeting.clear();
+    if(source == target){
+        meeting.push_back(source);
+        return 0;
     }
-    queue<Vertex<string>*> queue;
-    source->setNum(0);
-    queue.push(source);
-    source->setVisited(true);
-    while(!queue.empty()){
-        Vertex<string>* u = queue.front();
-        queue.pop();
-        unordered_set<Vertex<string>*> locations;
-        for(auto edge:u->getAdj()){
-            if(allowed.find(edge.getAirline()) != allowed.end() || allowed.find("all") != allowed.end()){
-                locations.insert(edge.getDest());
+    vector<uint32_t> forwardLayer = {source}, backwardLayer = {target}, next;
+    int forwardDepth = 0, backwardDepth = 0;
+    while(!forwardLayer.empty() && !backwardLayer.empty()){
+        next.clear();
+        if(forwardLayer.size() <= backwardLayer.size()){
+            forwardDepth++;
+            for(auto u : forwardLayer){
+                for(uint32_t e = csr.begin(u); e < csr.end(u); e++){
+                    uint32_t v = csr.targets[e];
+                    if(forward.isVisited(v) || (!all && !allowed.allows(csr.airlines[e]))){
+                        continue;
+                    }
+                    forward.visit(v, forwardDepth);
+                    next.push_back(v);
+                    if(backward.isVisited(v)){
+                        meeting.push_back(v);
+                    }
+                }
             }
+            forwardLayer.swap(next);
         }
-        for(auto location:locations){
-            if(location->isVisited()){
-                continue;
+        else{
+            backwardDepth++;
+            for(auto u : backwardLayer){
+                for(uint32_t e = csr.inBegin(u); e < csr.inEnd(u); e++){
+                    uint32_t v = csr.inSources[e];
+                    if(backward.isVisited(v) || (!all && !allowed.allows(csr.airlines[csr.inEdges[e]]))){
+                        continue;
+                    }
+                    backward.visit(v, backwardDepth);
+                    next.push_back(v);
+                    if(forward.isVisited(v)){
+                        meeting.push_back(v);
+                    }
+                }
             }
-
-            location->setNum(u->getNum()+1);
-            location->setVisited(true);
-            queue.push(location);
-
+            backwardLayer.swap(next);
         }
-    }
-
-
-}
-/**
- * @brief returns a version of the flightGraph with all of its edges reversed
- * @return reversed - the reversed version of the flightGraph
- * @details Time complexity: O(V+E), where V is the total number of vertices of the flight graph and E is the total number of edges in the graph.
- */
-Graph<string> Data:: getReverseGraph(){
-    Graph<string> reversed;
-    for(auto v: flightG->getVertexSet()){
-        Vertex<string>* newVertex = new Vertex<string>(v.second->getInfo());
-        newVertex->setVisited(false);
-        newVertex->setNum(v.second->getNum());
-        reversed.addVertex(newVertex);
-    }
-    for(auto v: flightG->getVertexSet()){
-        for(auto edge:v.second->getAdj()){
-            reversed.addEdge(edge.getDest()->getInfo(),v.second->getInfo(),edge.getWeight(),edge.getAirline());
+        if(!meeting.empty()){
+            return forwardDepth + backwardDepth;
         }
     }
-    return reversed;
+    return -1;
 }
 /**
- * @brief Traverses the reversed graph starting on the dest node and through nodes of distance one less of the current node.
- * @param dest
- * @param source
- * @param pathsDiscovered
- * @param path
- * @details Time complexity: O(E) where E is the number of outgoing edges of source.
+ * @brief Enumerates every shortest half trip between a meeting vertex and the source (or target) of a search.
+ * @details Walks the incoming edges towards the source when toTarget is false, and the outgoing edges towards the target
+ * otherwise, always to a vertex one step closer in ctx, so only the explored part of the graph is touched.
+ * Every half trip starts at the meeting vertex.
+ * @param v The current vertex.
+ * @param ctx The traversal state of the search that reached v.
+ * @param toTarget Whether ctx holds distances to the target (backward search) instead of from the source.
+ * @param allowed The allowed airline ids.
+ * @param path The current half trip.
+ * @param halves Receives every complete half trip.
+ * @details Time complexity: O(P*L), where P is the number of half trips and L their length.
  */
-void Data:: reverseDfsBestFlightOption(Vertex<string>* dest,Vertex<string>* source, vector<vector<string>> &pathsDiscovered,vector<string> path){
-
-    path.push_back(dest->getInfo());
-    if(dest == source){
-        reverse(path.begin(),path.end());
-        pathsDiscovered.push_back(path);
+void Data::halfPathsFromMeeting(uint32_t v, const TraversalContext &ctx, bool toTarget, const AirlineFilter &allowed,
+                                vector<uint32_t> &path, vector<vector<uint32_t>> &halves) {
+    const CSRGraph &csr = flightG->getCSR();
+    bool all = allowed.allowsAll();
+    path.push_back(v);
+    if(ctx.getDist(v) == 0){
+        halves.push_back(path);
+        path.pop_back();
         return;
     }
-    unordered_set<Vertex<string>*> locations;
-    for(auto edge:dest->getAdj()){
-        locations.insert(edge.getDest());
-    }
-    for(auto location:locations){
-        if(location->getNum() == dest->getNum() - 1){
-            reverseDfsBestFlightOption(location,source,pathsDiscovered,path);
-        }
-    }
-}
-
-/**
- * @brief Approximation algorithm for minimizing the number of airlines per path.
- * @param airlinesPerEdge
- * @return returnSet - set containing the approximation of the minimal set of airlines necessary.
- * @details Time complexity: Worst case scenario, when each flight in the path requires a different airlines, is O(N³) where N is the number of edges/airlines.
- */
-unordered_set<string> Data::optimizeAirlines(vector<vector<string>> airlinesPerEdge) {
-    unordered_set<string> returnSet;
-    unordered_map<int,unordered_set<string>> airlinesPerEdgeMapped;
-    unordered_set<int> edges;
-    unordered_set<string> totalAirlines;
-    for(int i = 0; i < airlinesPerEdge.size(); i++){
-        unordered_set<string> edge;
-        for(auto airline: airlinesPerEdge[i]){
-            edge.insert(airline);
-            totalAirlines.insert(airline);
+    vector<uint32_t> locations;
+    uint32_t begin = toTarget ? csr.begin(v) : csr.inBegin(v);
+    uint32_t end = toTarget ? csr.end(v) : csr.inEnd(v);
+    for(uint32_t e = begin; e < end; e++){
+        uint32_t location = toTarget ? csr.targets[e] : csr.inSources[e];
+        uint16_t airline = csr.airlines[toTarget ? e : csr.inEdges[e]];
+        if(ctx.getDist(location) == ctx.getDist(v) - 1 && (all || allowed.allows(airline))){
+            locations.push_back(location);
         }
-        airlinesPerEdgeMapped[i] = edge;
-        edges.insert(i);
     }
-
-    while(!edges.empty()){
-        string best_choice;
-        int max = INT_MIN;
-        for(auto airline: totalAirlines){
-            int edgesCovered = 0;
-            for(auto edge:edges){
-                if(airlinesPerEdgeMapped[edge].find(airline) != airlinesPerEdgeMapped[edge].end()){
-                    edgesCovered++;
-                }
-            }
-            if( edgesCovered > max){
-                max = edgesCovered;
-                best_choice = airline;
-            }
-        }
-        returnSet.insert(best_choice);
-
-        totalAirlines.erase(best_choice);
-        for(auto edge: airlinesPerEdgeMapped){
-            if(edge.second.find(best_choice) != edge.second.end()){
-                edges.erase(edge.first);
-            }
-        }
+    sort(locations.begin(), locations.end());
+    locations.erase(unique(locations.begin(), locations.end()), locations.end()); // one per airline otherwise
+    for(auto location : locations){
+        halfPathsFromMeeting(location, ctx, toTarget, allowed, path, halves);
     }
-
-    return returnSet;
+    path.pop_back();
 }
+
 /**
  * @brief Calculates the sum of destinations from a specified airport.
- * @details Time complexity: O(N), where N is the number of vertices in the flight graph.
+ * @details The counts are those of its strongly connected component, precomputed over the condensation DAG.
+ * Time complexity: O(1) once the decomposition is cached.
  */
 void Data::sumOfDestinationsAirport() {
     string airportCode;
     cout << "Airport code:";
     cin.ignore();
     getline(cin,airportCode);
-    auto it = airports_.find(airportCode);
-    if (it == airports_.end()) {
+    int id = airportIds_.find(airportCode);
+    if (id == -1) {
         cout << "Airport not found" << endl;
         return;
     }
-    vector<string> airports = flightG->bfs(airportCode);
-    unordered_set<string> countries;
-    unordered_set<City*> cities;
-    for(auto &adj:airports){
-        auto country = airports_[adj]->getCity()->getCountry();
-        auto city = airports_[adj]->getCity();
-        countries.insert(country);
-        cities.insert(city);
-    }
+    const StronglyConnectedComponents &scc = getStronglyConnectedComponents();
+    uint32_t component = scc.componentOf(id);
+    uint32_t airports = scc.reachableAirports(id), cities = cityReach_[component], countries = countryReach_[component];
     cout << "/******************************************/" << endl;
-    cout << "Sum of destinations from airport " << airportCode << " is " << airports.size() + countries.size() + cities.size() << endl;
-    cout << "Number of unique countries destinations is " << countries.size() << endl;
-    cout << "Number of unique cities destinations is " << cities.size() << endl;
-    cout << "Number of unique airports destinations is " << airports.size() << endl;
+    cout << "Sum of destinations from airport " << airportCode << " is " << airports + countries + cities << endl;
+    cout << "Number of unique countries destinations is " << countries << endl;
+    cout << "Number of unique cities destinations is " << cities << endl;
+    cout << "Number of unique airports destinations is " << airports << endl;
     cout << "/******************************************/" << endl;
 }
 /**
  * @brief Calculates the sum of destinations from a specified airport considering layovers.
- * @details Time complexity: O(V+E), where V is the number of vertices in the flight graph and E the edges.
+ * @details The airports are counted over the row of the airport in the hop matrix with HopMatrix::countWithin; the cities
+ * and countries are counted over the same row through their ids, with the epoch stamps of the two traversal contexts
+ * marking those already seen.
+ * Time complexity: O(V) once the matrix is loaded, where V is the number of vertices in the flight graph.
  */
 void Data::sumOfDestinationsAirportWithLayOvers() {
     string airportCode;
@@ -580,101 +1503,198 @@ void Data::sumOfDestinationsAirportWithLayOvers() {
     int layovers;
     cout << "Max number of layovers:";
     cin >> layovers;
-    auto it = airports_.find(airportCode);
-    if (it == airports_.end()) {
+    int id = airportIds_.find(airportCode);
+    if (id == -1) {
         cout << "Airport not found" << endl;
         return;
     }
-    unordered_set<string> airports;
-    unordered_set<string> countries;
-    unordered_set<City*> cities;
-    countDestinationsBFS(flightG->findVertex(airportCode),layovers,airports);
-    for(auto &airport : airports){
-        auto country = airports_[airport]->getCity()->getCountry();
-        auto city = airports_[airport]->getCity();
-        countries.insert(country);
-        cities.insert(city);
+    const HopMatrix &matrix = getHopMatrix();
+    uint32_t airports = matrix.countWithin(id, layovers), cities = 0, countries = 0;
+    TraversalContext &citySeen = traversal_, &countrySeen = reverseTraversal_; // city and country ids are below the number of airports
+    citySeen.reset(airports_.size());
+    countrySeen.reset(airports_.size());
+    if(airports > 0){
+        matrix.forEachWithin(id, layovers, [&](uint32_t airport) {
+            if(!citySeen.isVisited(cityOf_[airport])){
+                citySeen.visit(cityOf_[airport], 0);
+                cities++;
+            }
+            if(!countrySeen.isVisited(countryOf_[airport])){
+                countrySeen.visit(countryOf_[airport], 0);
+                countries++;
+            }
+        });
     }
     cout << "/******************************************/" << endl;
-    cout << "Sum of destinations from airport " << airportCode << " is " << airports.size() + countries.size() + cities.size() << endl;
-    cout << "Number of unique countries destinations is " << countries.size() << endl;
-    cout << "Number of unique cities destinations is " << cities.size() << endl;
-    cout << "Number of unique airports destinations is " << airports.size() << endl;
+    cout << "Sum of destinations from airport " << airportCode << " is " << airports + countries + cities << endl;
+    cout << "Number of unique countries destinations is " << countries << endl;
+    cout << "Number of unique cities destinations is " << cities << endl;
+    cout << "Number of unique airports destinations is " << airports << endl;
     cout << "/******************************************/" << endl;
 }
 /**
- * @brief Performs a breadth-first search to count the number of destinations from a specified airport.
- *
- * @param vertex The starting airport vertex.
- * @param maxStops The maximum number of layovers allowed.
- * @param visitedAirports An unordered set to store the visited airports.
- * @details Time complexity: O(N^2), where N is the number of vertices in the flight graph.
- */
-void Data::countDestinationsBFS(Vertex<string>* vertex, int maxStops, unordered_set<string>& visitedAirports) {
-    for (auto v : flightG->getVertexSet())
-        v.second->setVisited(false) ;
-    std::queue<pair<Vertex<string>*, int>> q;
-    q.push({vertex, 0});
-    vertex->setVisited(true);
-    while (!q.empty()) {
-        auto currentPair = q.front();
-        Vertex<string>* currentVertex = currentPair.first;
-        int currentStops = currentPair.second;
-        q.pop();
-
-        if (currentStops <= maxStops && currentStops != 0) {
-            visitedAirports.insert(currentVertex->getInfo());
-        }
-            for (auto &edge : currentVertex->getAdj()) {
-                Vertex<string>* neighbor = edge.getDest();
-                if (!neighbor->isVisited()) {
-                    neighbor->setVisited(true);
-                    q.push({neighbor, currentStops + 1});
+ * @brief Refreshes the traffic tables of every airport, city and country from the frozen flight graph.
+ * @details Called whenever the graph is frozen, after reading, loading or updating the network, so every statistic stays
+ * a lookup that reflects the last update.
+ * Time complexity: O(V+E+A+C), where A is the number of airlines and C the number of cities.
+ */
+void Data::countTraffic() {
+    uint32_t numCities, numCountries;
+    locationIds(cityOf_, numCities, countryOf_, numCountries);
+    vector<uint32_t> identity(airports_.size());
+    for(uint32_t id = 0; id < identity.size(); id++){
+        identity[id] = id;
+    }
+    aggregateTraffic(identity, identity.size(), airportTraffic_);
+    aggregateTraffic(cityOf_, numCities, cityTraffic_);
+    aggregateTraffic(countryOf_, numCountries, countryTraffic_);
+}
+/**
+ * @brief Sums the traffic of the airports of every group and counts the distinct airlines and destinations of its flights.
+ * @details The airports are bucketed by group first; every airline, airport, city and country then keeps the last group
+ * that counted it, so each is counted once per group without clearing anything between groups.
+ * Time complexity: O(V+E+A+C+G), where G is the number of groups.
+ * @param groupOf Group of every airport, below numGroups.
+ * @param numGroups The number of groups.
+ * @param res Ends up holding the traffic of every group.
+ */
+void Data::aggregateTraffic(const vector<uint32_t> &groupOf, uint32_t numGroups, vector<TrafficStats> &res) const {
+    const CSRGraph &csr = flightG->getCSR();
+    uint32_t n = csr.numVertices();
+    vector<uint32_t> offsets(numGroups + 1, 0), members(n);
+    for(uint32_t v = 0; v < n; v++){
+        offsets[groupOf[v] + 1]++;
+    }
+    for(uint32_t g = 0; g < numGroups; g++){
+        offsets[g + 1] += offsets[g];
+    }
+    vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+    for(uint32_t v = 0; v < n; v++){
+        members[next[groupOf[v]]++] = v;
+    }
+    const uint32_t NONE = UINT32_MAX;
+    // city and country ids are below the number of airports
+    vector<uint32_t> airlineSeen(airlineIds_.size(), NONE), destinationSeen(n, NONE), citySeen(n, NONE), countrySeen(n, NONE);
+    res.assign(numGroups, TrafficStats());
+    for(uint32_t g = 0; g < numGroups; g++){
+        TrafficStats &stats = res[g];
+        for(uint32_t i = offsets[g]; i < offsets[g + 1]; i++){
+            uint32_t v = members[i];
+            stats.flightsOut += csr.degree(v);
+            stats.flightsIn += csr.inDegree(v);
+            for(uint32_t e = csr.begin(v); e < csr.end(v); e++){
+                uint32_t target = csr.targets[e];
+                if(airlineSeen[csr.airlines[e]] != g){
+                    airlineSeen[csr.airlines[e]] = g;
+                    stats.airlines++;
+                }
+                if(destinationSeen[target] == g){
+                    continue;
+                }
+                destinationSeen[target] = g;
+                stats.destinations++;
+                if(citySeen[cityOf_[target]] != g){
+                    citySeen[cityOf_[target]] = g;
+                    stats.cities++;
+                }
+                if(countrySeen[countryOf_[target]] != g){
+                    countrySeen[countryOf_[target]] = g;
+                    stats.countries++;
                 }
             }
-
+        }
     }
 }
 /**
- * @brief Auxiliary comparator class for topKAirports
+ * @brief Traffic of one airport.
+ * @details Time complexity: O(1)
+ */
+const TrafficStats &Data::getAirportTraffic(uint32_t airport) const {
+    return airportTraffic_[airport];
+}
+/**
+ * @brief Traffic of one city.
+ * @details Time complexity: O(1) on average
+ * @param city_country The city and its country, as in "Porto,Portugal".
+ * @return The traffic of the city, or nullptr if there is no such city with airports.
  */
-class pairCompare{
-public:
-    bool operator()(pair<string,int> below,pair<string,int> above){
-        return below.second < above.second;
-
+const TrafficStats *Data::getCityTraffic(const string &city_country) const {
+    auto it = cities_.find(city_country);
+    if(it == cities_.end() || it->second->getAirports().empty()){
+        return nullptr;
     }
-};
+    return &cityTraffic_[cityOf_[it->second->getAirports()[0]]];
+}
 /**
- * @brief Prints the top K airports with the greatest air traffic capacity.
- * @param k The number of airports to display.
- * @details Time complexity: O(N log K), where N is the total number of vertices in the flight graph.
+ * @brief Traffic of one country.
+ * @details Time complexity: O(1) on average
+ * @param country The country.
+ * @return The traffic of the country, or nullptr if there is no such country with airports.
  */
-void Data::topKAirports(int k){
-    unordered_map<string,int> flightsPerAirport;
-    for(auto vertex: flightG->getVertexSet()){
-        flightsPerAirport[vertex.second->getInfo()] += vertex.second->getAdj().size();
-        for(auto edge:vertex.second->getAdj()){
-            flightsPerAirport[edge.getDest()->getInfo()]++;
+const TrafficStats *Data::getCountryTraffic(const string &country) const {
+    auto it = countries_.find(country);
+    if(it == countries_.end()){
+        return nullptr;
+    }
+    for(const auto &key : it->second->getCities()){
+        auto city = cities_.find(key);
+        if(city != cities_.end() && !city->second->getAirports().empty()){
+            return &countryTraffic_[countryOf_[city->second->getAirports()[0]]];
         }
     }
-    priority_queue<pair<string,int>,vector<pair<string,int>>,pairCompare> queue;
-    for(const auto& entry:flightsPerAirport){
-        queue.emplace(entry);
+    return nullptr;
+}
+/**
+ * @brief Prints the top K airports by air traffic.
+ * @param k The number of airports to display, at most the number of airports.
+ * @param mode The ranking: "flights" (incoming and outgoing), "in", "out", "airlines" (distinct airlines flying out) or
+ * "destinations" (distinct airports flown to).
+ * @details Selects the k best with nth_element over the airport traffic table and sorts only those; ties are listed in airport id order.
+ * Time complexity: O(N + K log K), where N is the total number of vertices in the flight graph.
+ */
+void Data::topKAirports(int k, const string &mode){
+    uint32_t n = airports_.size();
+    uint32_t TrafficStats::*field = mode == "in" ? &TrafficStats::flightsIn : mode == "out" ? &TrafficStats::flightsOut
+                                  : mode == "airlines" ? &TrafficStats::airlines : &TrafficStats::destinations;
+    bool flights = mode != "in" && mode != "out" && mode != "airlines" && mode != "destinations";
+    vector<uint32_t> score(n);
+    for(uint32_t id = 0; id < n; id++){
+        const TrafficStats &stats = airportTraffic_[id];
+        score[id] = flights ? stats.flightsIn + stats.flightsOut : stats.*field;
+    }
+    string label = mode == "in" ? "Incoming flights" : mode == "out" ? "Outgoing flights"
+                 : mode == "airlines" ? "Airlines" : mode == "destinations" ? "Destinations" : "Flights";
+    uint32_t count = k <= 0 ? 0 : min((uint32_t) k, n);
+    vector<uint32_t> ids(n);
+    for(uint32_t id = 0; id < n; id++){
+        ids[id] = id;
     }
-    cout << "The top " << k << " airports with the greatest air traffic capacity are:" << endl;
-    for(int i = 0; i < k ; i++){
-        cout << "Airport: " << queue.top().first << " Flights: " << queue.top().second << endl;
-        queue.pop();
+    auto better = [&](uint32_t a, uint32_t b){
+        return score[a] != score[b] ? score[a] > score[b] : a < b;
+    };
+    if(count < n){
+        nth_element(ids.begin(), ids.begin() + count, ids.end(), better);
+    }
+    sort(ids.begin(), ids.begin() + count, better);
+    if(flights){
+        cout << "The top " << count << " airports with the greatest air traffic capacity are:" << endl;
+    }
+    else{
+        string heading = label;
+        heading[0] = tolower(heading[0]);
+        cout << "The top " << count << " airports by " << heading << " are:" << endl;
+    }
+    for(uint32_t i = 0; i < count; i++){
+        cout << "Airport: " << airportIds_.getName(ids[i]) << " " << label << ": " << score[ids[i]] << endl;
     }
 }
 /**
- * @brief Checks and prints the maximum number of stops between airports using bfs.
- * @details Time complexity: O(N*(N+E)), where N is the total number of vertices in the flight graph and E is total number of edges in the graph.
+ * @brief Checks and prints the maximum number of stops between airports using the hop matrix.
+ * @details Time complexity: O(N²/(16*P) + T), where N is the total number of vertices in the flight graph, P the number of threads and T the number of pairs printed.
  */
 void Data::checkMaximumTripStops() {
 
-    stack<pair<string,string>> source_dest;
+    stack<pair<uint32_t,uint32_t>> source_dest;
     int numberOfStops = maxTrip(source_dest);
     cout << "/*********************************/" << endl;
     cout << "Maximum number of stops is " << numberOfStops << endl;
@@ -690,277 +1710,427 @@ void Data::checkMaximumTripStops() {
 
 
 /**
- * @brief Checks the maximum number of stops between airports using bfs.
- * @param maxTrips
+ * @brief Checks the maximum number of stops between airports using the hop matrix.
+ * @param maxTrips Filled with every (source, destination) pair at the maximum distance, in ascending order from the top.
  * @return maxDist - the distance of the longest trip(s)
- * @details Time complexity: O(N*(N+E)), where N is the total number of vertices in the flight graph and E is total number of edges in the graph.
- */
-int Data::maxTrip(stack<pair<string, string>> &maxTrips) {
-    int maxDist = INT_MIN;
-    stack<pair<string,string>> stack;
-    for(auto vertex: flightG->getVertexSet()){
-
-        int dist = findMaxTripBfs(stack,vertex.second);
-        if( dist > maxDist){
-            maxTrips = stack;
-            maxDist = dist;
-        }
-        else if( dist == maxDist){
-            while(!stack.empty()){
-                maxTrips.push(stack.top());
-                stack.pop();
-            }
-        }
-    }
-    return maxDist;
-}
-/**
- * @brief Using bfs, calculates the distance of each vertex from source, then finds the farthest vertices and creates pairs for them.
- * @param pairs
- * @param source
- * @details Time complexity: O(N+E), where N is the total number of vertices in the graph and E is the total number of edges in the graph
- * @return max number of stops that a trip can have
+ * @details The eccentricity of every airport is the maximum of its row, taken in parallel; only the rows that reach the
+ * diameter are scanned again for the pairs.
+ * Time complexity: O(N²/(16*P)) once the matrix is loaded, where N is the total number of vertices in the flight graph and P the number of threads.
  */
-int Data::findMaxTripBfs(stack<pair<string, string>> &pairs, Vertex<string> *source) {
-    unordered_set<Vertex<string>*> seen;
-    queue<Vertex<string>*> queue;
-    for(auto v: flightG->getVertexSet()){
-        v.second->setVisited(false);
-        v.second->setNum(INT_MIN);
+int Data::maxTrip(stack<pair<uint32_t, uint32_t>> &maxTrips) {
+    const HopMatrix &matrix = getHopMatrix();
+    uint32_t n = matrix.size();
+    vector<int> eccentricity(n);
+    parallelFor(n, [&](unsigned, uint32_t source) {
+        eccentricity[source] = matrix.eccentricity(source);
+    }, 64);
+    int maxDist = n == 0 ? 0 : *max_element(eccentricity.begin(), eccentricity.end());
+    maxTrips = stack<pair<uint32_t,uint32_t>>();
+    if(maxDist == 0){
+        return INT_MIN;
     }
-    source->setNum(0);
-    source->setVisited(true);
-    queue.push(source);
-    while(!queue.empty()){
-        Vertex<string>* u = queue.front();
-        queue.pop();
-        unordered_set<Vertex<string>*> locations;
-        for(auto edge: u->getAdj()){
-            locations.insert(edge.getDest());
+    for(uint32_t source = n; source-- > 0;){
+        if(eccentricity[source] != maxDist){
+            continue;
         }
-        for(auto location: locations){
-            if(!location->isVisited()){
-                seen.insert(location);
-                location->setNum(u->getNum()+1);
-                location->setVisited(true);
-                queue.push(location);
+        for(uint32_t dest = n; dest-- > 0;){
+            if(matrix.hops(source, dest) == maxDist){
+                maxTrips.push({source, dest});
             }
         }
-
-
-
-    }
-    int maxDist = INT_MIN;
-    for(Vertex<string>* vertex:seen){
-        if(vertex->getNum() > maxDist){
-            maxDist = vertex->getNum();
-            pairs = stack<pair<string,string>>();
-            pairs.push({source->getInfo(), vertex->getInfo()});
-        }
-        else if(vertex->getNum() == maxDist){
-            pairs.push({source->getInfo(), vertex->getInfo()});
-        }
     }
     return maxDist;
 }
-
 /**
- * @brief Finds essential airports for circulation in the graph.
- * @return A vector of essential airports.
-* @details Time complexity: O(V+E), where V is the number of vertices in the flight graph and E the edges.
+ * @brief Numbers the cities and countries of the airports densely, in the order their first airport appears.
+ * @details Time complexity: O(N), where N is the number of airports.
+ * @param cityOf Ends up holding the city id of every airport.
+ * @param numCities Ends up holding the number of cities with airports.
+ * @param countryOf Ends up holding the country id of every airport.
+ * @param numCountries Ends up holding the number of countries with airports.
  */
-
-vector<string> Data::essentialAirportsForCirculation(){
-    vector<string> airports;
-    stack<string> nodes;
-    for(auto vertex:flightG->getVertexSet()){
-        vertex.second->setNum(0);
-        vertex.second->setLow(0);
-        vertex.second->setVisited(false);
-        vertex.second->setProcessing(false);
+void Data::locationIds(vector<uint32_t> &cityOf, uint32_t &numCities, vector<uint32_t> &countryOf, uint32_t &numCountries) const {
+    unordered_map<City*, uint32_t> cityIds;
+    unordered_map<string, uint32_t> countryIds;
+    cityOf.resize(airports_.size());
+    countryOf.resize(airports_.size());
+    for(uint32_t id = 0; id < airports_.size(); id++){
+        City* city = airports_[id]->getCity();
+        cityOf[id] = cityIds.emplace(city, cityIds.size()).first->second;
+        countryOf[id] = countryIds.emplace(city->getCountry(), countryIds.size()).first->second;
     }
-    int i = 1;
-    for(auto vertice:flightG->getVertexSet()){
-        if(!vertice.second->isVisited()){
-            dfs_art(vertice.second,nodes,airports,i);
-        }
-    }
-    return airports;
+    numCities = cityIds.size();
+    numCountries = countryIds.size();
 }
 /**
- * @brief Depth-first search for finding essential airports for circulation.
- * @param currentVertex The current vertex during DFS.
- * @param traversalStack A stack to store the visited airports.
- * @param criticalAirports A vector to store the essential airports.
- * @param index An integer reference for assigning unique numbers to vertices.
+ * @brief Writes, for every airport, the number of airports, cities and countries reachable from it, its maximum number of stops
+ * and how many airports are first reached after each number of flights.
+ * @details Uses the same bit-parallel batches as the hop matrix, with one bitset per city and country to count them once per source.
+ * Time complexity: O(N*D*(N+E)/(64*P) + N²), where N is the total number of vertices in the flight graph, E is total number of edges in the graph, D the diameter and P the number of threads.
  */
-
-void Data::dfs_art(Vertex<string>* currentVertex, stack<string>& traversalStack, vector<string>& criticalAirports, int& index){
-    bool isArticulationPoint = false;
-    int childCount = 0;
-
-    currentVertex->setVisited(true);
-    currentVertex->setProcessing(true);
-    currentVertex->setNum(index);
-    currentVertex->setLow(index);
-    traversalStack.push(currentVertex->getInfo());
-    index++;
-
-    for (auto adjacentEdge : currentVertex->getAdj()) {
-        auto nextVertex = adjacentEdge.getDest();
-        if (!nextVertex->isVisited()) {
-            childCount++;
-            dfs_art(nextVertex, traversalStack, criticalAirports, index);
-
-            currentVertex->setLow(min(currentVertex->getLow(), nextVertex->getLow()));
-            if (nextVertex->getLow() >= currentVertex->getNum()) {
-                isArticulationPoint = true;
-            }
-        } else if (nextVertex->isProcessing()) {
-            currentVertex->setLow(min(currentVertex->getLow(), nextVertex->getNum()));
+void Data::reachabilityReport() {
+    const CSRGraph &csr = flightG->getCSR();
+    uint32_t n = csr.numVertices();
+    vector<uint32_t> cityOf, countryOf;
+    uint32_t numCities, numCountries;
+    locationIds(cityOf, numCities, countryOf, numCountries);
+    vector<int> airports(n, 0), cities(n, 0), countries(n, 0);
+    vector<vector<int>> perLevel(n);
+    uint32_t batches = (n + MultiSourceBFS::BATCH - 1) / MultiSourceBFS::BATCH;
+    parallelFor(batches, [&](unsigned, uint32_t batch) {
+        MultiSourceBFS search(csr);
+        vector<SourceSet> citySeen(numCities), countrySeen(numCountries);
+        for(auto &set : citySeen) set.clear();
+        for(auto &set : countrySeen) set.clear();
+        uint32_t first = batch * MultiSourceBFS::BATCH;
+        uint32_t count = min(MultiSourceBFS::BATCH, n - first);
+        vector<uint32_t> sources(count);
+        for(uint32_t i = 0; i < count; i++){
+            sources[i] = first + i;
         }
-    }
-
-    if ((currentVertex->getLow() == currentVertex->getNum() && childCount > 1) ||
-        (currentVertex->getLow() != currentVertex->getNum() && isArticulationPoint)) {
-        bool exitLoop = false;
-        while (true) {
-            string airport = traversalStack.top();
-            traversalStack.pop();
-            currentVertex->setProcessing(false);
-            if (airport == currentVertex->getInfo()) {
-                exitLoop = true;
-            }
-            if (exitLoop) {
-                break;
+        search.run(sources.data(), count, [&](int level, const vector<SourceSet> &reached) {
+            for(uint32_t v = 0; v < n; v++){
+                if(!reached[v].any()){
+                    continue;
+                }
+                SourceSet newCity = reached[v], newCountry = reached[v];
+                newCity.subtract(citySeen[cityOf[v]]);
+                citySeen[cityOf[v]].merge(newCity);
+                newCountry.subtract(countrySeen[countryOf[v]]);
+                countrySeen[countryOf[v]].merge(newCountry);
+                reached[v].forEach([&](uint32_t i) {
+                    airports[first + i]++;
+                    if(perLevel[first + i].size() <= (size_t) level){
+                        perLevel[first + i].resize(level + 1, 0);
+                    }
+                    perLevel[first + i][level]++;
+                });
+                newCity.forEach([&](uint32_t i) { cities[first + i]++; });
+                newCountry.forEach([&](uint32_t i) { countries[first + i]++; });
             }
+        });
+    });
+    ofstream output(REACHABILITY_REPORT);
+    if(!output.is_open()){
+        cout << "Could not open the file\n";
+        return;
+    }
+    output << "Code,Airports,Cities,Countries,MaxStops,AirportsPerFlights" << '\n';
+    for(uint32_t id = 0; id < n; id++){
+        output << airportIds_.getName(id) << ',' << airports[id] << ',' << cities[id] << ',' << countries[id] << ','
+               << (int) perLevel[id].size() - 1 << ',';
+        for(size_t level = 0; level < perLevel[id].size(); level++){
+            output << (level == 0 ? "" : ";") << perLevel[id][level];
         }
-        criticalAirports.push_back(currentVertex->getInfo());
+        output << '\n';
     }
+    cout << "/******************************************/" << endl;
+    cout << "Reachability of " << n << " airports written to " << REACHABILITY_REPORT << endl;
+    cout << "/******************************************/" << endl;
 }
 
+
 /**
  * @brief Checks and prints essential airports for circulation in the graph.
+ * @details Essential airports are the articulation points of the network seen as undirected, followed by the number of
+ * essential routes (bridges) and of biconnected components.
+ * Time complexity: O(A+C) once the decomposition is cached, where A is the number of essential airports and C the number of components.
  */
 
 void Data::checkEssentialAirports() {
-    vector<string> essentialAirports = essentialAirportsForCirculation();
+    const BiconnectedComponents &bcc = getBiconnectedComponents();
+    const vector<uint32_t> &essentialAirports = bcc.articulationPoints();
     cout << "Number of essential airports: " << essentialAirports.size() << endl;
     cout << "With them being: " << endl;
     for(const auto& airport:essentialAirports){
         cout << airports_[airport]->getName() << " - ";
     }
     cout << endl;
+    uint32_t largest = 0;
+    for(uint32_t i = 0; i < bcc.numComponents(); i++){
+        largest = max(largest, bcc.componentSize(i));
+    }
+    cout << "Number of essential routes (bridges): " << bcc.bridges().size() << endl;
+    cout << "Number of biconnected components: " << bcc.numComponents() << " | largest: " << largest << " airports" << endl;
 }
 
-/**
- * @brief Finds the best flight options from a set of source airports to a set of destination airports, while minimizing the number of airlines.
- * @param source A vector of Vertex pointers representing the source airports.
- * @param dest A vector of Vertex pointers representing the destination airports.
- * @param allowed A unordered set of strings representing the allowed airlines.
- * @details Time complexity: O(S*(V+E)), where S is the number of vertices in the source vector, V is the total number of vertices in the flight graph and E is the total number of edges in the graph.
- */
-void Data::bestFlightOptionMin(vector<Vertex<string> *> sourceNodes, vector<Vertex<string> *> destNodes,unordered_set<string> allowed) {
-    vector<pair<vector<string>,unordered_set<string>>> pathsDiscovered;
-    vector<string> path;
-    vector<vector<string>> airlinePerEdge;
-    for(auto sourceVertex: sourceNodes){
-        bfsBestFlightOption(sourceVertex,allowed);
-        Graph<string> reverse = getReverseGraph();
-        Vertex<string>* reverseSource = reverse.findVertex(sourceVertex->getInfo());
-        for(auto destVertex: destNodes){
-            Vertex<string>* reverseDest = reverse.findVertex(destVertex->getInfo());
-            reverseDfsBestFlightOptionMin(reverseDest,reverseSource,pathsDiscovered,path,airlinePerEdge);
-        }
-    }
-    filterForSmallestAndAirlines(pathsDiscovered);
-    cout << "Number of paths found: " << pathsDiscovered.size() << endl;
-    for(auto currentPath:pathsDiscovered){
-        for(auto airport: currentPath.first){
-            cout << airport << " -> ";
-        }
-        cout << currentPath.first.size() << " airports visited ";
+namespace {
+    /** @brief Time budget of a minimum airline search, in milliseconds */
+    const double MIN_AIRLINES_BUDGET = 250;
 
-        cout << "| " << currentPath.second.size() << " airlines used\n";
-    }
+    /** @brief Set of airlines, as a bitmask over the airlines of the search, that a group of itineraries uses to reach an airport */
+    struct AirlineLabel {
+        uint32_t airport;
+        bool dominated;
+        vector<uint32_t> parents;   // labels at the previous airport of the itineraries, none at a source
+    };
 }
 /**
- * @brief filters pathsDiscovered to only have the shortest paths.
- * @param pathsDiscovered
- * @details Time complexity: O(n) where n is the number of elements in the vector.
+ * @brief Breadth first search from every source at once, stopping at the layer where the first target is reached.
+ * @param sources The ids of the source airports, all at distance 0.
+ * @param targets The ids of the target airports.
+ * @param allowed The allowed airline ids, only their flights are taken.
+ * @param ctx Receives the distance of every airport reached, up to the returned one.
+ * @return The number of flights to the closest target, or -1 if none can be reached.
+ * @details Time complexity: O(V+E), where V is the number of airports and E the number of flights.
  */
-void Data::fiterForSmallest(vector<vector<string>> &pathsDiscovered) {
-    vector<vector<string>> result;
-    int minSize = INT_MAX;
-    for(auto path:pathsDiscovered){
-        if(path.size() < minSize ){
-            result.clear();
-            result.push_back(path);
-            minSize = path.size();
+int Data::multiSourceBfs(const vector<uint32_t> &sources, const vector<uint32_t> &targets, const AirlineFilter &allowed,
+                         TraversalContext &ctx) {
+    const CSRGraph &csr = flightG->getCSR();
+    bool all = allowed.allowsAll();
+    ctx.reset(csr.numVertices());
+    vector<bool> isTarget(csr.numVertices(), false);
+    for(auto target : targets){
+        isTarget[target] = true;
+    }
+    vector<uint32_t> layer, next;
+    for(auto source : sources){
+        if(!ctx.isVisited(source)){
+            ctx.visit(source, 0);
+            layer.push_back(source);
         }
-        else if ( path.size() == minSize){
-            result.push_back(path);
+    }
+    for(int depth = 0; !layer.empty(); depth++){
+        for(auto u : layer){
+            if(isTarget[u]){
+                return depth;
+            }
+        }
+        next.clear();
+        for(auto u : layer){
+            for(uint32_t e = csr.begin(u); e < csr.end(u); e++){
+                uint32_t v = csr.targets[e];
+                if(ctx.isVisited(v) || (!all && !allowed.allows(csr.airlines[e]))){
+                    continue;
+                }
+                ctx.visit(v, depth + 1);
+                next.push_back(v);
+            }
         }
+        layer.swap(next);
     }
-    pathsDiscovered = result;
+    return -1;
 }
 /**
- * @brief Traverses the reversed graph starting on the dest node and through nodes of distance one less of the current node.
- * @param dest
- * @param source
- * @param pathsDiscovered
- * @param path
- * @details Time complexity: O(E) where E is the number of outgoing edges of source.
+ * @brief Finds the best flight options from a set of source airports to a set of destination airports, while minimizing the number of airlines.
+ * @details Among the itineraries with the fewest flights, finds those that use the fewest airlines, without enumerating every
+ * itinerary. One multi-source BFS gives the number of flights and a backward pass keeps the airports and flights on some
+ * shortest itinerary. The airlines of those flights get dense bit positions, and labels (airport, airline set) are then
+ * propagated layer by layer from the sources, with itineraries reaching an airport with the same set sharing one label.
+ * A first pass drops every label whose set contains the set of another label at the same airport, as it can never end with
+ * fewer airlines, which gives the fewest airlines k. A second pass keeps every set of at most k airlines, so that all the
+ * itineraries tied at k are found, and its labels at the targets are unpacked into itineraries through their parents.
+ * The search has a budget of MIN_AIRLINES_BUDGET ms: past it, an airport that already has a label accepts no new set, unless
+ * the set dominates a label there, which keeps the rest linear but may miss the minimum; if the bounded pass runs out of
+ * budget, the pruned pass is run again. The listing stops at twice the budget, after at least one itinerary. These cases are reported.
+ * Time complexity: O(V+E + L*d*A/64), where L is the number of labels, d the out-degree of their airports and A the number of airlines on the shortest itineraries.
+ * @param sourceNodes A vector of Vertex pointers representing the source airports.
+ * @param destNodes A vector of Vertex pointers representing the destination airports.
+ * @param allowed The allowed airlines.
  */
-void Data::reverseDfsBestFlightOptionMin(Vertex<string> *dest, Vertex<string> *source,vector<pair<vector<string>, unordered_set<string>>> &pathsDiscovered,vector<string> path, vector<vector<string>> airlinesPerEdge) {
-    path.push_back(dest->getInfo());
-    if(dest == source){
-        reverse(path.begin(),path.end());
-        unordered_set<string> optimized = optimizeAirlines(airlinesPerEdge);
-        pathsDiscovered.push_back({path,optimized});
+void Data::bestFlightOptionMin(vector<Vertex<string> *> sourceNodes, vector<Vertex<string> *> destNodes, const AirlineFilter &allowed) {
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&start](){ return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); };
+    const CSRGraph &csr = flightG->getCSR();
+    bool all = allowed.allowsAll();
+    vector<uint32_t> sources, targets;
+    for(auto vertex : sourceNodes){
+        sources.push_back(vertex->getId());
+    }
+    for(auto vertex : destNodes){
+        targets.push_back(vertex->getId());
+    }
+    int hops = multiSourceBfs(sources, targets, allowed, traversal_);
+    if(hops == -1){
+        cout << "Number of paths found: 0" << endl;
         return;
     }
-    unordered_map<Vertex<string>*,vector<string>> locations;
-    for(auto edge:dest->getAdj()){
-        locations[edge.getDest()].push_back(edge.getAirline());
+
+    // airports on a shortest itinerary, by layer, found backwards from the closest targets
+    vector<vector<uint32_t>> layers(hops + 1);
+    TraversalContext &useful = reverseTraversal_;
+    useful.reset(csr.numVertices());
+    for(auto target : targets){
+        if(traversal_.getDist(target) == hops && !useful.isVisited(target)){
+            useful.visit(target, hops);
+            layers[hops].push_back(target);
+        }
     }
-    for(auto location:locations){
-        if(location.first->getNum() == dest->getNum() - 1){
-            vector<vector<string>>  newAirlines = airlinesPerEdge;
-            newAirlines.push_back(location.second);
-            reverseDfsBestFlightOptionMin(location.first,source,pathsDiscovered,path,newAirlines);
+    vector<int> bit(airlines_.size(), -1);
+    int numAirlines = 0;
+    for(int i = hops; i > 0; i--){
+        for(auto v : layers[i]){
+            for(uint32_t e = csr.inBegin(v); e < csr.inEnd(v); e++){
+                uint32_t u = csr.inSources[e];
+                uint16_t airline = csr.airlines[csr.inEdges[e]];
+                if(traversal_.getDist(u) != i - 1 || (!all && !allowed.allows(airline))){
+                    continue;
+                }
+                if(bit[airline] == -1){
+                    bit[airline] = numAirlines++;
+                }
+                if(!useful.isVisited(u)){
+                    useful.visit(u, i - 1);
+                    layers[i - 1].push_back(u);
+                }
+            }
         }
     }
-}
-/**
- * @brief filters pathsDiscovered to only have the paths that are shortest and have the least airlines.
- * @param pathsDiscovered
- * @details Time complexity: O(n) where n is the number of elements in the vector.
- */
-void Data::filterForSmallestAndAirlines(vector<pair<vector<string>, unordered_set<string>>> &pathsDiscovered) {
-    int minAirports = INT_MAX;
-    int minAirlines = INT_MAX;
-    vector<pair<vector<string>, unordered_set<string>>> result;
-    for(auto path:pathsDiscovered){
-        if(path.first.size() < minAirports){
-            result.clear();
-            result.push_back(path);
-            minAirports = path.first.size();
-            minAirlines = path.second.size();
+
+    const uint32_t words = max(1, (numAirlines + 63) / 64);
+    vector<AirlineLabel> labels;
+    vector<uint64_t> masks;  // words per label
+    vector<vector<uint32_t>> labelsAt(csr.numVertices());
+    vector<uint64_t> mask(words);
+    bool overBudget = false;
+    auto popcount = [&](uint32_t label){
+        int count = 0;
+        for(uint32_t w = 0; w < words; w++){
+            count += __builtin_popcountll(masks[(size_t) label * words + w]);
+        }
+        return count;
+    };
+    // prune: drop the labels whose set contains another one; otherwise keep every set of at most bound airlines
+    auto addLabel = [&](uint32_t airport, int parent, bool prune){
+        bool dominates = false;
+        for(auto other : labelsAt[airport]){
+            if(labels[other].dominated){
+                continue;
+            }
+            const uint64_t *otherMask = &masks[(size_t) other * words];
+            bool otherInNew = true, newInOther = true;
+            for(uint32_t w = 0; w < words; w++){
+                otherInNew = otherInNew && (otherMask[w] & ~mask[w]) == 0;
+                newInOther = newInOther && (mask[w] & ~otherMask[w]) == 0;
+            }
+            if(otherInNew && newInOther){ // same set, the itineraries share the label
+                if(parent != -1 && (labels[other].parents.empty() || labels[other].parents.back() != (uint32_t) parent)){
+                    labels[other].parents.push_back(parent);
+                }
+                return;
+            }
+            if(prune && otherInNew){
+                return;
+            }
+            if(prune && newInOther){
+                labels[other].dominated = true;
+                dominates = true;
+            }
         }
-        else if (path.first.size() == minAirports){
-            if(path.second.size() < minAirlines){
-                result.clear();
-                result.push_back(path);
-                minAirlines = path.second.size();
+        if(overBudget && !dominates && !labelsAt[airport].empty()){ // a label that replaces dominated ones is always kept
+            return;
+        }
+        labelsAt[airport].push_back(labels.size());
+        labels.push_back({airport, false, {}});
+        if(parent != -1){
+            labels.back().parents.push_back(parent);
+        }
+        masks.insert(masks.end(), mask.begin(), mask.end());
+    };
+    auto propagate = [&](bool prune, int bound){
+        labels.clear();
+        masks.clear();
+        for(const auto &layer : layers){
+            for(auto airport : layer){
+                labelsAt[airport].clear();
             }
-            else if(path.second.size() == minAirlines){
-                result.push_back(path);
+        }
+        fill(mask.begin(), mask.end(), 0);
+        for(auto source : layers[0]){
+            addLabel(source, -1, prune);
+        }
+        for(int i = 0; i < hops; i++){
+            for(auto u : layers[i]){
+                overBudget = overBudget || elapsed() > MIN_AIRLINES_BUDGET;
+                for(uint32_t l = 0; l < labelsAt[u].size(); l++){
+                    uint32_t label = labelsAt[u][l];
+                    if(labels[label].dominated){
+                        continue;
+                    }
+                    for(uint32_t e = csr.begin(u); e < csr.end(u); e++){
+                        uint32_t v = csr.targets[e];
+                        uint16_t airline = csr.airlines[e];
+                        if(!useful.isVisited(v) || useful.getDist(v) != i + 1 || (!all && !allowed.allows(airline))){
+                            continue;
+                        }
+                        copy(masks.begin() + (size_t) label * words, masks.begin() + (size_t) (label + 1) * words, mask.begin());
+                        mask[bit[airline] / 64] |= (uint64_t) 1 << (bit[airline] % 64);
+                        bool withinBound = true;
+                        if(bound != INT_MAX){
+                            int count = 0;
+                            for(uint32_t w = 0; w < words; w++){
+                                count += __builtin_popcountll(mask[w]);
+                            }
+                            withinBound = count <= bound;
+                        }
+                        if(withinBound){
+                            addLabel(v, label, prune);
+                        }
+                    }
+                }
+            }
+        }
+        int fewest = INT_MAX;
+        for(auto target : layers[hops]){
+            for(auto label : labelsAt[target]){
+                if(!labels[label].dominated){
+                    fewest = min(fewest, popcount(label));
+                }
             }
         }
+        return fewest;
+    };
+    // the pruned pass finds the fewest airlines, the bounded pass keeps every itinerary that uses that many
+    int fewest = propagate(true, INT_MAX);
+    if(!overBudget && propagate(false, fewest) != fewest){ // the bounded pass ran out of budget before keeping every set
+        fewest = propagate(true, INT_MAX);
+    }
+    if(fewest == INT_MAX){
+        cout << "Number of paths found: 0" << endl;
+        cout << "Search time budget exhausted before reaching a destination" << endl;
+        return;
     }
-    pathsDiscovered = result;
 
+    vector<vector<uint32_t>> itineraries;
+    vector<uint32_t> path;
+    bool truncated = false;
+    function<void(uint32_t)> unpack = [&](uint32_t label){
+        path.push_back(labels[label].airport);
+        if(labels[label].parents.empty()){
+            itineraries.emplace_back(path.rbegin(), path.rend());
+        }
+        for(auto parent : labels[label].parents){
+            if(!itineraries.empty() && elapsed() > 2 * MIN_AIRLINES_BUDGET){ // always list at least one
+                truncated = true;
+                break;
+            }
+            unpack(parent);
+        }
+        path.pop_back();
+    };
+    for(auto target : layers[hops]){
+        for(auto label : labelsAt[target]){
+            if(!labels[label].dominated && popcount(label) == fewest){
+                unpack(label);
+            }
+        }
+    }
+    sort(itineraries.begin(), itineraries.end());
+    itineraries.erase(unique(itineraries.begin(), itineraries.end()), itineraries.end());
+    cout << "Number of paths found: " << itineraries.size() << endl;
+    for(const auto &itinerary : itineraries){
+        for(auto airport : itinerary){
+            cout << airportIds_.getName(airport) << " -> ";
+        }
+        cout << itinerary.size() << " airports visited ";
+        cout << "| " << fewest << " airlines used\n";
+    }
+    if(overBudget){
+        cout << "Search time budget exhausted, the number of airlines may not be the minimum" << endl;
+    }
+    if(truncated){
+        cout << "Listing time budget exhausted, more paths were omitted" << endl;
+    }
 }
 
 
@@ -15,12 +15,32 @@
 #include "City.h"
 #include "Country.h"
 #include "Graph.h"
+#include "SymbolTable.h"
+#include "TraversalContext.h"
+#include "Parallel.h"
+#include "MultiSourceBFS.h"
+#include "DaryHeap.h"
+#include "ContractionHierarchy.h"
+#include "Snapshot.h"
+#include "NetworkUpdate.h"
+#include "SpatialIndex.h"
+#include "CoordinateBatch.h"
+#include "AirlineFilter.h"
+#include "BiconnectedComponents.h"
+#include "StronglyConnectedComponents.h"
+#include "HopMatrix.h"
+#include "TrafficStats.h"
+#include "../../common/CsvReader.h"
 #include <unordered_map>
 #include <map>
 
 #define AIRLINES "../csv/airlines.csv"
 #define AIRPORTS "../csv/airports.csv"
 #define FLIGHTS "../csv/flights.csv"
+#define REACHABILITY_REPORT "../csv/reachability_report.csv"
+#define CONTRACTION_HIERARCHY "../csv/flights.ch"
+#define SNAPSHOT "../csv/network.snapshot"
+#define HOP_MATRIX "../csv/flights.hops"
 /**
  * @brief Class that stores and processes useful data from the csv files
  */
@@ -28,43 +48,97 @@ class Data {
 private:
     /** @brief Represents the number of flights. This variable is used to keep track of the total number of flights in the system */
     int nf = 0;
-    /** @brief A hash map that stores airline objects using their unique codes as keys.
+    /** @brief Interns the airline codes into dense ids, in the order of airlines.csv */
+    SymbolTable airlineIds_;
+    /** @brief A vector that stores airline objects indexed by their airline id.
      * @details Time complexity - O(1) for access
      * */
-    unordered_map <string, Airline*> airlines_ ;
+    vector<Airline*> airlines_ ;
     /** @brief A hash map that stores city objects using their names as keys.
     * @details Time complexity - O(1) for access
     * */
     unordered_map <string, City*> cities_; // cities O(1)
-    /** @brief A hash map that stores airport objects using their names as keys.
+    /** @brief Interns the airport codes into dense ids, which are also the vertex ids of the flight graph */
+    SymbolTable airportIds_;
+    /** @brief A vector that stores airport objects indexed by their airport id.
     * @details Time complexity - O(1) for access
     */
-    unordered_map <string, Airport*> airports_; // airports O(1)
+    vector<Airport*> airports_; // airports O(1)
     /** @brief A hash map that stores country objects using their names as keys.
   * @details Time complexity - O(1) for access
   */
     unordered_map <string, Country*> countries_;
-    /** @brief A hash map that tracks the number of flights operated by each airline. It associates airline codes with the corresponding count of flights
+    /** @brief A vector that tracks the number of flights operated by each airline, indexed by airline id
 */
-    unordered_map<string,int> airline_flights;
+    vector<int> airline_flights;
+    /** @brief City and country id of every airport, as numbered by locationIds */
+    vector<uint32_t> cityOf_;
+    vector<uint32_t> countryOf_;
+    /** @brief Traffic of every airport, city and country, indexed by their ids and refreshed whenever the flight graph is frozen */
+    vector<TrafficStats> airportTraffic_;
+    vector<TrafficStats> cityTraffic_;
+    vector<TrafficStats> countryTraffic_;
     /** @brief A pointer to a graph data structure that represents the network of flights. The graph likely contains vertices representing airports and edges representing flights between them
 */
     Graph<string>* flightG;
     /** @brief A vector of pairs where each pair consists of an airport code and its geographical coordinates. This information is useful for mapping the spatial layout of airports
      */
     vector<pair<string, Coordinate>> airportCoord_;
+    /** @brief Spatial index over the coordinates of the airports, for the nearest airport lookups */
+    SpatialIndex airportIndex_;
+    /** @brief Traversal state reused by the queries issued from the menu */
+    TraversalContext traversal_;
+    /** @brief Traversal state of the backward half of the bidirectional searches issued from the menu */
+    TraversalContext reverseTraversal_;
+    /** @brief Tentative distance, in meters, of every airport discovered by the last shortest distance search */
+    vector<double> routeDist_;
+    /** @brief Heuristic estimate of the remaining distance of every airport discovered by the last A* search */
+    vector<double> routeEstimate_;
+    /** @brief Previous airport and airline of the best known trip to every discovered airport */
+    vector<pair<uint32_t, uint16_t>> routeParent_;
+    /** @brief Priority queue of the shortest distance searches */
+    DaryHeap<4> routeHeap_;
+    /** @brief Contraction hierarchy of the flight graph, loaded (or built) on the first query that needs it */
+    ContractionHierarchy* ch_ = nullptr;
+    /** @brief Biconnected decomposition of the flight graph, computed on the first query that needs it */
+    BiconnectedComponents* bcc_ = nullptr;
+    /** @brief Strongly connected decomposition of the flight graph, computed on the first query that needs it */
+    StronglyConnectedComponents* scc_ = nullptr;
+    /** @brief Number of cities and of countries reachable from every strongly connected component, filled with scc_ */
+    vector<uint32_t> cityReach_;
+    vector<uint32_t> countryReach_;
+    /** @brief Number of flights between every pair of airports, loaded (or built) on the first query that needs it */
+    HopMatrix* hops_ = nullptr;
 
 public:
+    /** @brief Pseudo airline id of the first airport of a route, which no flight leads to */
+    static constexpr uint16_t NO_AIRLINE = UINT16_MAX;
+    /** @brief Relative margin the A* estimate is shrunk by, far above the rounding error of the distance kernel */
+    static constexpr double HEURISTIC_MARGIN = 1e-9;
 
     Data();
-    unordered_map <string, Airport*> getAirports();
-    unordered_map <string, Airline*> getAirlines();
-    unordered_map <string, City*> getCities();
-    unordered_map <string, Country*> getCountries();
+    const vector<Airport*> &getAirports() const;
+    const vector<Airline*> &getAirlines() const;
+    const unordered_map <string, City*> &getCities() const;
+    const unordered_map <string, Country*> &getCountries() const;
     Graph<string>* getFlightG();
+    int findAirport(const string& code) const;
+    int findAirline(const string& code) const;
+    const string& getAirportCode(uint32_t id) const;
+    const string& getAirlineCode(uint16_t id) const;
     void read_airlines();
     void read_airports();
     void read_flights();
+    uint16_t internAirline(const string &code);
+    bool readUpdates(const string &path, vector<NetworkUpdate> &updates);
+    int applyUpdates(const vector<NetworkUpdate> &updates);
+    bool loadSnapshot(const string &path);
+    bool saveSnapshot(const string &path) const;
+    void buildAirportIndex();
+    vector<pair<double, uint32_t>> nearestAirports(const Coordinate &center, uint32_t k) const;
+    vector<pair<double, uint32_t>> airportsWithinRadius(const Coordinate &center, double radius) const;
+    void listNearestAirports(const Coordinate &coordinate, int k) const;
+    void catchmentBenchmark(int queries);
     void listAllAirportsAndAvailableFlights() const;
     void flightsOutFromAirportAndDifferentAirlines();
     void numberOfFlightsPerCity_Airline(string city_airline);
@@ -74,68 +148,70 @@ public:
     void numberOfUniqueCountriesReachableAirport_City(string airport_city);
     void sumOfDestinationsAirport();
     void sumOfDestinationsAirportWithLayOvers();
-    void topKAirports(int k);
+    void countTraffic();
+    void aggregateTraffic(const vector<uint32_t> &groupOf, uint32_t numGroups, vector<TrafficStats> &res) const;
+    const TrafficStats &getAirportTraffic(uint32_t airport) const;
+    const TrafficStats *getCityTraffic(const string &city_country) const;
+    const TrafficStats *getCountryTraffic(const string &country) const;
+    void topKAirports(int k, const string &mode);
     void checkMaximumTripStops();
 
 
-    int maxTrip(stack<pair<string, string>> &maxTrips);
+    int maxTrip(stack<pair<uint32_t, uint32_t>> &maxTrips);
 
-    int findMaxTripBfs(stack<pair<string, string>> &pairs, Vertex<string> *source);
+    void locationIds(vector<uint32_t> &cityOf, uint32_t &numCities, vector<uint32_t> &countryOf, uint32_t &numCountries) const;
 
-    void checkEssentialAirports();
+    void reachabilityReport();
 
-    void dfs_art(Vertex<string> *v, stack<string> &s, vector<string> &airports, int &i);
+    void checkEssentialAirports();
 
 
-    void countDestinationsBFS(Vertex<string> *vertex, int maxStops, unordered_set<string> &visitedAirports);
 
 
 
-    void bestFlightOption(string sourceMode, string source, string destMode, string dest, unordered_set<string> allowed,
+    void bestFlightOption(string sourceMode, string source, string destMode, string dest, const AirlineFilter &allowed,
                           bool min);
 
 
-
-
-
     void
     bestFlightOption(vector<Vertex<string> *> source, vector<Vertex<string> *> dest,
-                     const unordered_set<string> &allowed);
-
-
-
-
+                     const AirlineFilter &allowed);
 
 
+    void bestFlightOptionMin(vector<Vertex<string> *> sourceNodes, vector<Vertex<string> *> destNodes,
+                             const AirlineFilter &allowed);
 
+    int multiSourceBfs(const vector<uint32_t> &sources, const vector<uint32_t> &targets, const AirlineFilter &allowed,
+                       TraversalContext &ctx);
 
-    Graph<string> getReverseGraph();
 
 
-    void
-    reverseDfsBestFlightOption(Vertex<string> *dest, Vertex<string> *source, vector<vector<string>> &pathsDiscovered,
-                               vector<string> path);
 
+    void shortestDistanceOption(string sourceMode, string source, string destMode, string dest, const AirlineFilter &allowed,
+                                string algorithm);
 
-    void fiterForSmallest(vector<vector<string>> &pathsDiscovered);
+    ContractionHierarchy &getContractionHierarchy();
 
-    void bestFlightOptionMin(vector<Vertex<string> *> sourceNodes, vector<Vertex<string> *> destNodes,
-                             unordered_set<string> allowed);
+    BiconnectedComponents &getBiconnectedComponents();
 
+    StronglyConnectedComponents &getStronglyConnectedComponents();
 
+    HopMatrix &getHopMatrix();
 
-    unordered_set<string> optimizeAirlines(vector<vector<string>> edge);
+    void shortestDistanceBenchmark(int pairs);
 
+    void csvReaderBenchmark();
 
-    void reverseDfsBestFlightOptionMin(Vertex<string> *dest, Vertex<string> *source,
-                                       vector<pair<vector<string>, unordered_set<string>>> &pathsDiscovered,
-                                       vector<string> path, vector<vector<string>> airlinesPerEdge);
+    void distanceAccuracyCheck();
 
-    void filterForSmallestAndAirlines(vector<pair<vector<string>, unordered_set<string>>> &pathsDiscovered);
+    double shortestDistance(const vector<uint32_t> &sources, const vector<uint32_t> &targets, const AirlineFilter &allowed,
+                            bool heuristic, vector<pair<uint32_t, uint16_t>> &route, uint32_t &settled);
 
-    vector<string> essentialAirportsForCirculation();
+    int bidirectionalBfs(uint32_t source, uint32_t target, const AirlineFilter &allowed, TraversalContext &forward,
+                         TraversalContext &backward, vector<uint32_t> &meeting);
 
-    void bfsBestFlightOption(Vertex<string> *source, unordered_set<string> allowed);
+    void halfPathsFromMeeting(uint32_t v, const TraversalContext &ctx, bool toTarget, const AirlineFilter &allowed,
+                              vector<uint32_t> &path, vector<vector<uint32_t>> &halves);
 };
 
 
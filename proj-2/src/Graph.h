@@ -6,13 +6,15 @@
 #define PROJETO_AED_2_GRAPH_H
 
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <queue>
 #include <stack>
-#include <list>
 #include <unordered_map>
 #include <string>
+#include "TraversalContext.h"
 using namespace std;
 
 template <class T> class Edge;
@@ -25,40 +27,28 @@ template <class T> class Vertex;
 template <class T>
 class Vertex {
     T info;                // contents
+    uint32_t id;           // dense index of the vertex in its graph
     vector<Edge<T> > adj;  // list of outgoing edges
-    bool visited;          // auxiliary field
-    bool processing;       // auxiliary field
     int indegree;          // auxiliary field
-    int num;               // auxiliary field
-    int low;               // auxiliary field
 
 
 private:
     //auxiliary field
 
     bool removeEdgeTo(Vertex<T> *d);
+    bool removeEdgeTo(Vertex<T> *d, uint16_t airline);
+    int removeEdgesOf(uint16_t airline);
 public:
-    void addEdge(Vertex<T> *dest, double w, string airline);
+    void addEdge(Vertex<T> *dest, double w, uint16_t airline);
     Vertex(T in);
     T getInfo() const;
+    uint32_t getId() const;
     void setInfo(T in);
-    bool isVisited() const;
-    void setVisited(bool v);
-    bool isProcessing() const;
-    void setProcessing(bool p);
     const vector<Edge<T>> &getAdj() const;
     void setAdj(const vector<Edge<T>> &adj);
     int getIndegree() const;
     void setIndegree(int indegree);
 
-    int getNum() const;
-
-    void setNum(int num);
-
-    int getLow() const;
-
-    void setLow(int low);
-
     friend class Graph<T>;
     Vertex<T> *getParent() const;
     void setParent(Vertex<T> *parent);
@@ -69,42 +59,80 @@ template <class T>
 class Edge {
     Vertex<T> * dest;      // destination vertexz
     double weight;         // edge weight
-    string airline; // airline code
+    uint16_t airline;      // interned airline code
 public:
-    Edge(Vertex<T> *d, double w,string airline);
+    Edge(Vertex<T> *d, double w,uint16_t airline);
     Vertex<T> *getDest() const;
     void setDest(Vertex<T> *dest);
     double getWeight() const;
     void setWeight(double weight);
-    string getAirline()const ;
-    void setAirline(string airline);
+    uint16_t getAirline()const ;
+    void setAirline(uint16_t airline);
     friend class Graph<T>;
     friend class Vertex<T>;
 };
 
 
+/**
+ * @brief Frozen compressed sparse row (CSR) representation of a graph.
+ * @details The outgoing edges of the vertex with id v are the positions
+ * [offsets[v], offsets[v+1]) of the targets, weights and airlines arrays, so a
+ * traversal reads contiguous memory instead of chasing Vertex and Edge pointers.
+ * The incoming edges of v are likewise the positions [inOffsets[v], inOffsets[v+1]) of
+ * inSources and inEdges, the latter pointing back into the outgoing arrays.
+ */
+struct CSRGraph {
+    vector<uint32_t> offsets;      // size V+1, first edge of every vertex
+    vector<uint32_t> targets;      // size E, destination vertex ids
+    vector<double> weights;        // size E, edge weights
+    vector<uint16_t> airlines;     // size E, interned airline ids
+    vector<uint32_t> inOffsets;    // size V+1, first incoming edge of every vertex
+    vector<uint32_t> inSources;    // size E, source vertex ids of the incoming edges
+    vector<uint32_t> inEdges;      // size E, position of every incoming edge in targets
+
+    uint32_t numVertices() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    uint32_t numEdges() const { return targets.size(); }
+    uint32_t begin(uint32_t v) const { return offsets[v]; }
+    uint32_t end(uint32_t v) const { return offsets[v + 1]; }
+    uint32_t degree(uint32_t v) const { return offsets[v + 1] - offsets[v]; }
+    uint32_t inBegin(uint32_t v) const { return inOffsets[v]; }
+    uint32_t inEnd(uint32_t v) const { return inOffsets[v + 1]; }
+    uint32_t inDegree(uint32_t v) const { return inOffsets[v + 1] - inOffsets[v]; }
+};
+
+
 
 template <class T>
 class Graph {
     unordered_map<string,Vertex<T> *> vertexSet;      // vertex set
-    int _index_;                        // auxiliary field
-    stack<Vertex<T>> _stack_;           // auxiliary field
-    list<list<T>> _list_sccs_;        // auxiliary field
+    vector<Vertex<T> *> vertices;       // vertices indexed by id
+    CSRGraph csr;                       // frozen adjacency, valid while frozen is true
+    bool frozen = false;
 
-    void dfsVisit(Vertex<T> *v,  vector<T> & res) const;
-    bool dfsIsDAG(Vertex<T> *v) const;
+    void dfsVisit(uint32_t v, TraversalContext &ctx, vector<T> & res) const;
+    bool dfsIsDAG(uint32_t v, TraversalContext &ctx) const;
 public:
     Vertex<T> *findVertex(const T &in) const;
+    Vertex<T> *getVertex(uint32_t id) const;
     int getNumVertex() const;
     bool addVertex(const T &in);
     void addVertex(Vertex<T>* v);
     bool removeVertex(const T &in);
-    bool addEdge(const T &sourc, const T &dest, double w,string airline);
+    bool addEdge(const T &sourc, const T &dest, double w,uint16_t airline);
     bool removeEdge(const T &sourc, const T &dest);
-    unordered_map<string, Vertex<T> *> getVertexSet() const;
+    void addEdge(uint32_t sourc, uint32_t dest, double w, uint16_t airline);
+    bool removeEdge(uint32_t sourc, uint32_t dest, uint16_t airline);
+    int removeEdgesOf(uint16_t airline);
+    const unordered_map<string, Vertex<T> *> &getVertexSet() const;
+    const vector<Vertex<T> *> &getVertices() const;
+    void freeze();
+    bool isFrozen() const;
+    const CSRGraph &getCSR() const;
     vector<T> dfs() const;
     vector<T> dfs(const T & source) const;
     vector<T> bfs(const T &source) const;
+    vector<uint32_t> bfsIds(uint32_t source) const;
+    vector<uint32_t> bfsIds(uint32_t source, TraversalContext &ctx) const;
     vector<T> topsort() const;
     bool isDAG() const;
 
@@ -115,10 +143,10 @@ public:
 /****************** Provided constructors and functions ********************/
 
 template <class T>
-Vertex<T>::Vertex(T in): info(in) {}
+Vertex<T>::Vertex(T in): info(in), id(0) {}
 
 template <class T>
-Edge<T>::Edge(Vertex<T> *d, double w,string airline): dest(d), weight(w),airline(airline) {}
+Edge<T>::Edge(Vertex<T> *d, double w,uint16_t airline): dest(d), weight(w),airline(airline) {}
 
 
 template <class T>
@@ -127,28 +155,31 @@ int Graph<T>::getNumVertex() const {
 }
 
 template <class T>
-unordered_map<string,Vertex<T> * > Graph<T>::getVertexSet() const {
+const unordered_map<string,Vertex<T> * > &Graph<T>::getVertexSet() const {
     return vertexSet;
 }
 
-template<class T>
-T Vertex<T>::getInfo() const {
-    return info;
+/*
+ * Read-only view of the vertices, indexed by id.
+ */
+template <class T>
+const vector<Vertex<T> *> &Graph<T>::getVertices() const {
+    return vertices;
 }
 
 template<class T>
-void Vertex<T>::setInfo(T in) {
-    Vertex::info = in;
+T Vertex<T>::getInfo() const {
+    return info;
 }
 
 template<class T>
-bool Vertex<T>::isProcessing() const {
-    return processing;
+uint32_t Vertex<T>::getId() const {
+    return id;
 }
 
 template<class T>
-void Vertex<T>::setProcessing(bool p) {
-    Vertex::processing = p;
+void Vertex<T>::setInfo(T in) {
+    Vertex::info = in;
 }
 
 template<class T>
@@ -171,11 +202,11 @@ void Edge<T>::setWeight(double weight) {
     Edge::weight = weight;
 }
 template<class T>
-void Edge<T>::setAirline(std::string airline) {
+void Edge<T>::setAirline(uint16_t airline) {
     Edge::airline = airline;
 }
 template<class T>
-string Edge<T>::getAirline() const{
+uint16_t Edge<T>::getAirline() const{
     return airline;
 }
 
@@ -191,9 +222,12 @@ Vertex<T> * Graph<T>::findVertex(const T &in) const {
     return NULL;
 }
 
+/*
+ * Returns the vertex with the given dense id, in constant time.
+ */
 template <class T>
-bool Vertex<T>::isVisited() const {
-    return visited;
+Vertex<T> * Graph<T>::getVertex(uint32_t id) const {
+    return vertices[id];
 }
 
 template<class T>
@@ -206,31 +240,6 @@ void Vertex<T>::setIndegree(int indegree) {
     Vertex::indegree = indegree;
 }
 
-template<class T>
-int Vertex<T>::getNum() const {
-    return num;
-}
-
-template<class T>
-void Vertex<T>::setNum(int num) {
-    Vertex::num = num;
-}
-
-template<class T>
-int Vertex<T>::getLow() const {
-    return low;
-}
-
-template<class T>
-void Vertex<T>::setLow(int low) {
-    Vertex::low = low;
-}
-
-template <class T>
-void Vertex<T>::setVisited(bool v) {
-    Vertex::visited = v;
-}
-
 template<class T>
 const vector<Edge<T>> &Vertex<T>::getAdj() const {
     return adj;
@@ -250,12 +259,19 @@ template <class T>
 bool Graph<T>::addVertex(const T &in) {
     if ( findVertex(in) != NULL)
         return false;
-    vertexSet[in] = new Vertex<T>(in);
+    auto v = new Vertex<T>(in);
+    v->id = vertices.size();
+    vertices.push_back(v);
+    vertexSet[in] = v;
+    frozen = false;
     return true;
 }
 template <class T>
 void Graph<T> ::addVertex(Vertex<T>* v){
+    v->id = vertices.size();
+    vertices.push_back(v);
     vertexSet[v->getInfo()] = v;
+    frozen = false;
 }
 
 
@@ -265,12 +281,13 @@ void Graph<T> ::addVertex(Vertex<T>* v){
  * Returns true if successful, and false if the source or destination vertex does not exist.
  */
 template <class T>
-bool Graph<T>::addEdge(const T &sourc, const T &dest, double w,string airline) {
+bool Graph<T>::addEdge(const T &sourc, const T &dest, double w,uint16_t airline) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == NULL || v2 == NULL)
         return false;
     v1->addEdge(v2,w,airline);
+    frozen = false;
     return true;
 }
 
@@ -279,7 +296,7 @@ bool Graph<T>::addEdge(const T &sourc, const T &dest, double w,string airline) {
  * with a given destination vertex (d) and edge weight (w).
  */
 template <class T>
-void Vertex<T>::addEdge(Vertex<T> *d, double w,string airline) {
+void Vertex<T>::addEdge(Vertex<T> *d, double w,uint16_t airline) {
     adj.push_back(Edge<T>(d, w,airline));
 }
 
@@ -295,6 +312,7 @@ bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
     auto v2 = findVertex(dest);
     if (v1 == NULL || v2 == NULL)
         return false;
+    frozen = false;
     return v1->removeEdgeTo(v2);
 }
 
@@ -313,6 +331,65 @@ bool Vertex<T>::removeEdgeTo(Vertex<T> *d) {
     return false;
 }
 
+/**
+ * Adds an edge between the vertices with ids sourc and dest, which must exist.
+ */
+template <class T>
+void Graph<T>::addEdge(uint32_t sourc, uint32_t dest, double w, uint16_t airline) {
+    vertices[sourc]->addEdge(vertices[dest], w, airline);
+    frozen = false;
+}
+
+/**
+ * Removes one edge from sourc to dest with the given airline.
+ * Returns true if successful, and false if such edge does not exist.
+ */
+template <class T>
+bool Graph<T>::removeEdge(uint32_t sourc, uint32_t dest, uint16_t airline) {
+    if (sourc >= vertices.size() || dest >= vertices.size())
+        return false;
+    frozen = false;
+    return vertices[sourc]->removeEdgeTo(vertices[dest], airline);
+}
+
+/**
+ * Removes every edge with the given airline from the graph (this).
+ * Returns the number of edges removed.
+ */
+template <class T>
+int Graph<T>::removeEdgesOf(uint16_t airline) {
+    int removed = 0;
+    for (auto v : vertices)
+        removed += v->removeEdgesOf(airline);
+    frozen = false;
+    return removed;
+}
+
+/**
+ * Auxiliary function to remove one outgoing edge with a given destination (d) and airline from a vertex (this).
+ * Returns true if successful, and false if such edge does not exist.
+ */
+template <class T>
+bool Vertex<T>::removeEdgeTo(Vertex<T> *d, uint16_t airline) {
+    for (auto it = adj.begin(); it != adj.end(); it++)
+        if (it->dest == d && it->airline == airline) {
+            adj.erase(it);
+            return true;
+        }
+    return false;
+}
+
+/**
+ * Auxiliary function to remove every outgoing edge with a given airline from a vertex (this),
+ * keeping the order of the others. Returns the number of edges removed.
+ */
+template <class T>
+int Vertex<T>::removeEdgesOf(uint16_t airline) {
+    size_t before = adj.size();
+    adj.erase(remove_if(adj.begin(), adj.end(), [airline](const Edge<T> &e) { return e.airline == airline; }), adj.end());
+    return before - adj.size();
+}
+
 /**
  *  Removes a vertex with a given content (in) from a graph (this), and
  *  all outgoing and incoming edges.
@@ -320,16 +397,77 @@ bool Vertex<T>::removeEdgeTo(Vertex<T> *d) {
  */
 template <class T>
 bool Graph<T>::removeVertex(const T &in) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); it++)
-        if ((*it)->info  == in) {
-            auto v = *it;
-            vertexSet.erase(it);
-            for (auto u : vertexSet)
-                u->removeEdgeTo(v);
-            delete v;
-            return true;
+    auto it = vertexSet.find(in);
+    if (it == vertexSet.end())
+        return false;
+    auto v = it->second;
+    vertexSet.erase(it);
+    for (auto u : vertices)
+        u->removeEdgeTo(v);
+    // keeps the ids dense by moving the last vertex into the freed slot
+    vertices[v->id] = vertices.back();
+    vertices[v->id]->id = v->id;
+    vertices.pop_back();
+    delete v;
+    frozen = false;
+    return true;
+}
+
+
+/****************** CSR ********************/
+/**
+ * Builds the compressed sparse row representation of the graph (this) from the
+ * adjacency lists of its vertices, together with the index of incoming edges.
+ * Must be called again after the graph is modified.
+ * Time complexity: O(V+E)
+ */
+template <class T>
+void Graph<T>::freeze() {
+    csr = CSRGraph();
+    csr.offsets.resize(vertices.size() + 1, 0);
+    for (size_t i = 0; i < vertices.size(); i++)
+        csr.offsets[i + 1] = csr.offsets[i] + vertices[i]->adj.size();
+    uint32_t numEdges = csr.offsets.back();
+    csr.targets.reserve(numEdges);
+    csr.weights.reserve(numEdges);
+    csr.airlines.reserve(numEdges);
+    for (auto v : vertices) {
+        for (auto & e : v->adj) {
+            csr.targets.push_back(e.dest->id);
+            csr.weights.push_back(e.weight);
+            csr.airlines.push_back(e.airline);
         }
-    return false;
+    }
+    csr.inOffsets.assign(vertices.size() + 1, 0);
+    for (auto t : csr.targets)
+        csr.inOffsets[t + 1]++;
+    for (size_t i = 0; i < vertices.size(); i++)
+        csr.inOffsets[i + 1] += csr.inOffsets[i];
+    csr.inSources.resize(numEdges);
+    csr.inEdges.resize(numEdges);
+    vector<uint32_t> next(csr.inOffsets.begin(), csr.inOffsets.end() - 1);
+    for (uint32_t v = 0; v < vertices.size(); v++) {
+        for (uint32_t e = csr.begin(v); e < csr.end(v); e++) {
+            uint32_t pos = next[csr.targets[e]]++;
+            csr.inSources[pos] = v;
+            csr.inEdges[pos] = e;
+        }
+    }
+    frozen = true;
+}
+
+template <class T>
+bool Graph<T>::isFrozen() const {
+    return frozen;
+}
+
+/**
+ * Returns the frozen representation of the graph (this).
+ * Only valid after freeze() and until the next modification.
+ */
+template <class T>
+const CSRGraph &Graph<T>::getCSR() const {
+    return csr;
 }
 
 
@@ -337,31 +475,41 @@ bool Graph<T>::removeVertex(const T &in) {
 /**
  * Performs a depth-first search (dfs) traversal in a graph (this).
  * Returns a vector with the contents of the vertices by dfs order.
- * Follows the algorithm described in theoretical classes.
+ * Follows the algorithm described in theoretical classes, over the frozen representation.
  */
 template <class T>
 vector<T> Graph<T>::dfs() const {
     vector<T> res;
-    for (auto v : vertexSet)
-        v->visited = false;
-    for (auto v : vertexSet)
-        if (! v->visited)
-            dfsVisit(v, res);
+    TraversalContext ctx(csr.numVertices());
+    for (uint32_t v = 0; v < csr.numVertices(); v++)
+        if (! ctx.isVisited(v))
+            dfsVisit(v, ctx, res);
     return res;
 }
 
 /**
- * Auxiliary function that visits a vertex (v) and its adjacent, recursively.
+ * Auxiliary function that visits a vertex (v) and its adjacent over the frozen
+ * representation, keeping an explicit stack of (vertex, next edge) pairs.
  * Updates a parameter with the list of visited node contents.
  */
 template <class T>
-void Graph<T>::dfsVisit(Vertex<T> *v, vector<T> & res) const {
-    v->visited = true;
-    res.push_back(v->info);
-    for (auto & e : v->adj) {
-        auto w = e.dest;
-        if ( ! w->visited)
-            dfsVisit(w, res);
+void Graph<T>::dfsVisit(uint32_t v, TraversalContext &ctx, vector<T> & res) const {
+    stack<pair<uint32_t, uint32_t>> pending;
+    ctx.visit(v, 0);
+    res.push_back(vertices[v]->info);
+    pending.push({v, csr.begin(v)});
+    while (!pending.empty()) {
+        auto & top = pending.top();
+        if (top.second == csr.end(top.first)) {
+            pending.pop();
+            continue;
+        }
+        auto w = csr.targets[top.second++];
+        if ( ! ctx.isVisited(w)) {
+            ctx.visit(w, 0);
+            res.push_back(vertices[w]->info);
+            pending.push({w, csr.begin(w)});
+        }
     }
 }
 
@@ -370,7 +518,7 @@ void Graph<T>::dfsVisit(Vertex<T> *v, vector<T> & res) const {
 /**
  * Performs a depth-first search (dfs) in a graph (this).
  * Returns a vector with the contents of the vertices by dfs order,
- * from the source node.
+ * from the source node. Runs over the frozen representation.
  */
 template <class T>
 vector<T> Graph<T>::dfs(const T & source) const {
@@ -378,11 +526,8 @@ vector<T> Graph<T>::dfs(const T & source) const {
     auto s = findVertex(source);
     if (s == nullptr)
         return res;
-
-    for (auto v : vertexSet)
-        v->visited = false;
-
-    dfsVisit(s, res);
+    TraversalContext ctx(csr.numVertices());
+    dfsVisit(s->id, ctx, res);
     return res;
 }
 
@@ -392,6 +537,7 @@ vector<T> Graph<T>::dfs(const T & source) const {
  * Performs a breadth-first search (bfs) in a graph (this), starting
  * from the vertex with the given source contents (source).
  * Returns a vector with the contents of the vertices by bfs order.
+ * Runs over the frozen representation.
  */
 template <class T>
 vector<T> Graph<T>::bfs(const T & source) const {
@@ -399,20 +545,43 @@ vector<T> Graph<T>::bfs(const T & source) const {
     auto s = findVertex(source);
     if (s == NULL)
         return res;
-    queue<Vertex<T> *> q;
-    for (auto v : vertexSet)
-        v.second->visited = false;
-    q.push(s);
-    s->visited = true;
+    for (auto v : bfsIds(s->id))
+        res.push_back(vertices[v]->info);
+    return res;
+}
+
+/**
+ * Performs a breadth-first search (bfs) in a graph (this), starting
+ * from the vertex with the given id (source).
+ * Returns a vector with the ids of the vertices by bfs order.
+ * Runs over the frozen representation.
+ */
+template <class T>
+vector<uint32_t> Graph<T>::bfsIds(uint32_t source) const {
+    TraversalContext ctx;
+    return bfsIds(source, ctx);
+}
+
+/**
+ * Same as bfsIds(source), keeping the traversal state in a caller-owned context (ctx),
+ * which is reset in O(1) and afterwards holds the number of edges from source to every visited vertex.
+ */
+template <class T>
+vector<uint32_t> Graph<T>::bfsIds(uint32_t source, TraversalContext &ctx) const {
+    vector<uint32_t> res;
+    ctx.reset(csr.numVertices());
+    queue<uint32_t> q;
+    q.push(source);
+    ctx.visit(source, 0);
     while (!q.empty()) {
         auto v = q.front();
         q.pop();
-        res.push_back(v->info);
-        for (auto & e : v->adj) {
-            auto w = e.dest;
-            if ( ! w->visited ) {
+        res.push_back(v);
+        for (uint32_t e = csr.begin(v); e < csr.end(v); e++) {
+            auto w = csr.targets[e];
+            if ( ! ctx.isVisited(w) ) {
                 q.push(w);
-                w->visited = true;
+                ctx.visit(w, ctx.getDist(v) + 1);
             }
         }
     }
@@ -431,13 +600,10 @@ vector<T> Graph<T>::bfs(const T & source) const {
 
 template <class T>
 bool Graph<T>::isDAG() const {
-    for (auto v : vertexSet) {
-        v->visited = false;
-        v->processing = false;
-    }
-    for (auto v : vertexSet)
-        if (! v->visited)
-            if ( ! dfsIsDAG(v) )
+    TraversalContext ctx(csr.numVertices());
+    for (uint32_t v = 0; v < csr.numVertices(); v++)
+        if (! ctx.isVisited(v))
+            if ( ! dfsIsDAG(v, ctx) )
                 return false;
     return true;
 }
@@ -447,18 +613,18 @@ bool Graph<T>::isDAG() const {
  * Returns false (not acyclic) if an edge to a vertex in the stack is found.
  */
 template <class T>
-bool Graph<T>::dfsIsDAG(Vertex<T> *v) const {
-    v->visited = true;
-    v->processing = true;
-    for (auto & e : v->adj) {
-        auto w = e.dest;
-        if (w->processing)
+bool Graph<T>::dfsIsDAG(uint32_t v, TraversalContext &ctx) const {
+    ctx.visit(v, 0);
+    ctx.setProcessing(v, true);
+    for (uint32_t e = csr.begin(v); e < csr.end(v); e++) {
+        auto w = csr.targets[e];
+        if (ctx.isProcessing(w))
             return false;
-        if (! w->visited)
-            if (! dfsIsDAG(w))
+        if (! ctx.isVisited(w))
+            if (! dfsIsDAG(w, ctx))
                 return false;
     }
-    v->processing = false;
+    ctx.setProcessing(v, false);
     return true;
 }
 
@@ -472,13 +638,12 @@ bool Graph<T>::dfsIsDAG(Vertex<T> *v) const {
  * Follows the algorithm described in theoretical classes.
  */
 
-template<class T>
-void topsortUtil(Vertex<T>* vertex, stack<Vertex<T>*> & s) {
-    vertex->setVisited(true);
-    for (Edge<T> edge : vertex->getAdj()) {
-        auto neighbor = edge.getDest();
-        if (!neighbor->isVisited()) {
-            topsortUtil(neighbor, s);
+inline void topsortUtil(const CSRGraph &csr, uint32_t vertex, TraversalContext &ctx, stack<uint32_t> & s) {
+    ctx.visit(vertex, 0);
+    for (uint32_t e = csr.begin(vertex); e < csr.end(vertex); e++) {
+        auto neighbor = csr.targets[e];
+        if (!ctx.isVisited(neighbor)) {
+            topsortUtil(csr, neighbor, ctx, s);
         }
     }
     s.push(vertex);
@@ -487,17 +652,15 @@ void topsortUtil(Vertex<T>* vertex, stack<Vertex<T>*> & s) {
 template<class T>
 vector<T> Graph<T>::topsort() const {
     vector<T> res;
-    stack<Vertex<T>*> s;
-    for (Vertex<T> * vertex : this->vertexSet) {
-        vertex->setVisited(false);
-    }
-    for (Vertex<T>* vertex : this->vertexSet) {
-        if (!vertex->isVisited())
-            topsortUtil(vertex, s);
+    stack<uint32_t> s;
+    TraversalContext ctx(csr.numVertices());
+    for (uint32_t vertex = 0; vertex < csr.numVertices(); vertex++) {
+        if (!ctx.isVisited(vertex))
+            topsortUtil(csr, vertex, ctx, s);
     }
 
     while (!s.empty()) {
-        res.push_back(s.top()->getInfo());
+        res.push_back(vertices[s.top()]->getInfo());
         s.pop();
     }
     return res;
@@ -0,0 +1,175 @@
+#include "HopMatrix.h"
+#include <algorithm>
+#include <fstream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "ContractionHierarchy.h"
+#include "MultiSourceBFS.h"
+#include "Parallel.h"
+
+namespace {
+    const uint32_t HOPS_MAGIC = 0x4d484541;   // "AEHM"
+    const uint32_t HOPS_VERSION = 1;
+
+    template <class T>
+    void writeValue(ofstream &out, const T &value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <class T>
+    bool readValue(ifstream &in, T &value) {
+        return (bool) in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+}
+
+/**
+ * @brief Fills the matrix with a breadth first search from every airport.
+ * @details The sources are split into batches of MultiSourceBFS::BATCH that are searched bit-parallel, and the batches
+ * run on a pool of threads; every batch writes only its own rows.
+ * Time complexity - O(V*D*(V+E)/(64*P) + V^2), where D is the diameter and P the number of threads
+ * @param csr The frozen flight graph.
+ */
+void HopMatrix::build(const CSRGraph &csr) {
+    n_ = csr.numVertices();
+    fingerprint_ = ContractionHierarchy::fingerprint(csr);
+    hops_.assign((size_t) n_ * n_, UNREACHABLE);
+    uint32_t batches = (n_ + MultiSourceBFS::BATCH - 1) / MultiSourceBFS::BATCH;
+    parallelFor(batches, [&](unsigned, uint32_t batch) {
+        MultiSourceBFS search(csr);
+        uint32_t first = batch * MultiSourceBFS::BATCH;
+        uint32_t count = min(MultiSourceBFS::BATCH, n_ - first);
+        vector<uint32_t> sources(count);
+        for (uint32_t i = 0; i < count; i++) {
+            sources[i] = first + i;
+        }
+        search.run(sources.data(), count, [&](int level, const vector<SourceSet> &reached) {
+            uint8_t hops = (uint8_t) min(level, (int) MAX_HOPS);
+            for (uint32_t v = 0; v < n_; v++) {
+                reached[v].forEach([&](uint32_t i) {
+                    hops_[(size_t) (first + i) * n_ + v] = hops;
+                });
+            }
+        });
+    });
+}
+
+/**
+ * @brief Writes the matrix to a binary file.
+ * @details Time complexity - O(V^2)
+ * @param path The file to write.
+ * @return Whether the file was written.
+ */
+bool HopMatrix::save(const string &path) const {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    writeValue(out, HOPS_MAGIC);
+    writeValue(out, HOPS_VERSION);
+    writeValue(out, fingerprint_);
+    writeValue(out, n_);
+    out.write(reinterpret_cast<const char *>(hops_.data()), hops_.size());
+    return (bool) out;
+}
+
+/**
+ * @brief Reads a matrix written by save.
+ * @details Time complexity - O(V^2)
+ * @param path The file to read.
+ * @param fingerprint The fingerprint of the current flight graph, a file built from another graph is rejected.
+ * @return Whether a valid matrix for this graph was loaded; if not, the matrix is left empty.
+ */
+bool HopMatrix::load(const string &path, uint64_t fingerprint) {
+    ifstream in(path, ios::binary);
+    uint32_t magic, version;
+    if (!in.is_open() || !readValue(in, magic) || !readValue(in, version) || magic != HOPS_MAGIC || version != HOPS_VERSION
+        || !readValue(in, fingerprint_) || fingerprint_ != fingerprint || !readValue(in, n_)) {
+        n_ = 0;
+        return false;
+    }
+    hops_.resize((size_t) n_ * n_);
+    if (!in.read(reinterpret_cast<char *>(hops_.data()), hops_.size())) {
+        n_ = 0;
+        hops_.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Number of airports of the matrix.
+ * @details Time complexity - O(1)
+ */
+uint32_t HopMatrix::size() const {
+    return n_;
+}
+
+/**
+ * @brief Number of flights of the shortest trip from source to target, 0 if they are the same airport.
+ * @details Time complexity - O(1)
+ * @return The number of flights, or UNREACHABLE.
+ */
+uint8_t HopMatrix::hops(uint32_t source, uint32_t target) const {
+    return hops_[(size_t) source * n_ + target];
+}
+
+/**
+ * @brief The hop counts from source to every airport, indexed by airport id.
+ * @details Time complexity - O(1)
+ */
+const uint8_t *HopMatrix::row(uint32_t source) const {
+    return hops_.data() + (size_t) source * n_;
+}
+
+/**
+ * @brief Number of airports, other than source, reachable from source with at most maxHops flights.
+ * @details An entry h is counted when h - 1, wrapping around in a byte, is at most maxHops - 1, which leaves out both
+ * the source (0) and the unreachable airports (255).
+ * Time complexity - O(V/16)
+ */
+uint32_t HopMatrix::countWithin(uint32_t source, int maxHops) const {
+    if (maxHops <= 0) {
+        return 0;
+    }
+    uint8_t bound = (uint8_t) (min(maxHops, (int) MAX_HOPS) - 1);
+    const uint8_t *hops = row(source);
+    uint32_t count = 0, v = 0;
+#ifdef __SSE2__
+    const __m128i ones = _mm_set1_epi8(1), limit = _mm_set1_epi8((char) bound);
+    for (; v + 16 <= n_; v += 16) {
+        __m128i shifted = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hops + v)), ones);
+        __m128i inside = _mm_cmpeq_epi8(_mm_min_epu8(shifted, limit), shifted);
+        count += __builtin_popcount(_mm_movemask_epi8(inside));
+    }
+#endif
+    for (; v < n_; v++) {
+        count += (uint8_t) (hops[v] - 1) <= bound;
+    }
+    return count;
+}
+
+/**
+ * @brief Largest number of flights from source to an airport it reaches, 0 if it reaches none.
+ * @details Adding 1 to every entry turns the unreachable ones into 0, so a plain unsigned maximum skips them.
+ * Time complexity - O(V/16)
+ */
+int HopMatrix::eccentricity(uint32_t source) const {
+    const uint8_t *hops = row(source);
+    uint8_t best = 0;
+    uint32_t v = 0;
+#ifdef __SSE2__
+    const __m128i ones = _mm_set1_epi8(1);
+    __m128i maxima = _mm_setzero_si128();
+    for (; v + 16 <= n_; v += 16) {
+        maxima = _mm_max_epu8(maxima, _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hops + v)), ones));
+    }
+    uint8_t lanes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), maxima);
+    best = *max_element(lanes, lanes + 16);
+#endif
+    for (; v < n_; v++) {
+        best = max(best, (uint8_t) (hops[v] + 1));
+    }
+    return best == 0 ? 0 : best - 1;
+}
@@ -0,0 +1,61 @@
+#ifndef PROJETO_AED_2_HOPMATRIX_H
+#define PROJETO_AED_2_HOPMATRIX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * @brief Class that stores the number of flights of the shortest trip between every pair of airports, one byte per pair
+ * @details The rows are filled by bit-parallel breadth first searches spread over a pool of threads, and can be saved
+ * to disk and loaded back as long as the flight graph they were built from has not changed. Queries over a row compare
+ * 16 entries at a time with SSE2 and count the matches from the compare mask. Hop counts saturate at MAX_HOPS.
+ */
+class HopMatrix {
+private:
+    uint32_t n_ = 0;
+    /** @brief Fingerprint of the flight graph the matrix was built from */
+    uint64_t fingerprint_ = 0;
+    /** @brief hops_[s * n_ + t] is the number of flights from s to t, or UNREACHABLE */
+    vector<uint8_t> hops_;
+
+public:
+    static constexpr uint8_t UNREACHABLE = 255;
+    static constexpr uint8_t MAX_HOPS = 254;
+
+    void build(const CSRGraph &csr);
+    bool save(const string &path) const;
+    bool load(const string &path, uint64_t fingerprint);
+
+    uint32_t size() const;
+    uint8_t hops(uint32_t source, uint32_t target) const;
+    const uint8_t *row(uint32_t source) const;
+    uint32_t countWithin(uint32_t source, int maxHops) const;
+
+    /**
+     * @brief Calls f(airport) for every airport, other than source, reachable from source with at most maxHops flights,
+     * in ascending id order.
+     * @details Time complexity - O(V)
+     */
+    template <class F>
+    void forEachWithin(uint32_t source, int maxHops, F f) const {
+        if (maxHops <= 0) {
+            return;
+        }
+        uint8_t bound = (uint8_t) (min(maxHops, (int) MAX_HOPS) - 1);
+        const uint8_t *hops = row(source);
+        for (uint32_t v = 0; v < n_; v++) {
+            if ((uint8_t) (hops[v] - 1) <= bound) {
+                f(v);
+            }
+        }
+    }
+    int eccentricity(uint32_t source) const;
+};
+
+
+#endif //PROJETO_AED_2_HOPMATRIX_H
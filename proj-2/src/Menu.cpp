@@ -19,6 +19,27 @@ int Menu::run(){
             case 2:
                 listBestFlightOptions();
                 break;
+            case 3:
+                listShortestDistanceOption();
+                break;
+            case 4:
+                benchmarkShortestDistance();
+                break;
+            case 5:
+                data.csvReaderBenchmark();
+                break;
+            case 6:
+                applyNetworkUpdates();
+                break;
+            case 7:
+                listNearestAirports();
+                break;
+            case 8:
+                benchmarkCatchment();
+                break;
+            case 9:
+                data.distanceAccuracyCheck();
+                break;
             default:
                 std::cout << "Invalid option try again" << std::endl;
         }
@@ -48,7 +69,7 @@ void Menu::listBestFlightOptions() {
     if(!flightOptionsInput(destMode,dest)){
         return;
     }
-    unordered_set<string> allowed = getAllowedFilter();
+    AirlineFilter allowed = getAllowedFilter();
     string minimize;
     cout << "Do you wish to minimize the number of airlines used? ( Y / N ):";
     cin >> minimize;
@@ -77,6 +98,108 @@ void Menu::listBestFlightOptions() {
     data.bestFlightOption(sourceMode,source,destMode,dest,allowed,min);
 
 }
+/**
+ * @brief Applies the batch of network updates in a csv file chosen by the user.
+ * @details Time complexity - O(U*d + V + E), see Data::applyUpdates.
+ */
+void Menu::applyNetworkUpdates() {
+    string path;
+    cout << "Enter the path of the updates file:";
+    cin >> path;
+    vector<NetworkUpdate> updates;
+    if(!data.readUpdates(path,updates)){
+        cout << "Could not open the file" << endl;
+        return;
+    }
+    int applied = data.applyUpdates(updates);
+    cout << applied << " of " << updates.size() << " updates applied" << endl;
+}
+/**
+ * @brief Lists the airports closest to the geographical coordinates given by the user.
+ * @details Time complexity - O(k log k + log V), where k is the number of airports listed and V the number of airports.
+ */
+void Menu::listNearestAirports() {
+    double latitude, longitude;
+    int k;
+    coordinatesInput(latitude,longitude);
+    cout << "Enter the number of airports:";
+    cin >> k;
+    while(cin.fail() || k <= 0){
+        cin.clear();
+        cin.ignore();
+        cout << "Invalid number - try again" << endl;
+        cout << "Enter the number of airports:";
+        cin >> k;
+    }
+    data.listNearestAirports(Coordinate(latitude,longitude),k);
+}
+/**
+ * @brief Times the catchment queries of the spatial index against a linear scan, on a number of random locations chosen by the user.
+ * @details Time complexity - O(Q*V), where Q is the number of locations and V the number of airports.
+ */
+void Menu::benchmarkCatchment() {
+    int queries;
+    cout << "Enter the number of random locations:";
+    cin >> queries;
+    while(cin.fail() || queries <= 0){
+        cin.clear();
+        cin.ignore();
+        cout << "Invalid number - try again" << endl;
+        cout << "Enter the number of random locations:";
+        cin >> queries;
+    }
+    data.catchmentBenchmark(queries);
+}
+/**
+ * @brief Times the contraction hierarchy against Dijkstra on a number of random airport pairs chosen by the user.
+ * @details Time complexity - O(P*(V+E) log V), where P is the number of pairs.
+ */
+void Menu::benchmarkShortestDistance() {
+    int pairs;
+    cout << "Enter the number of random airport pairs:";
+    cin >> pairs;
+    while(cin.fail() || pairs <= 0){
+        cin.clear();
+        cin.ignore();
+        cout << "Invalid number - try again" << endl;
+        cout << "Enter the number of random airport pairs:";
+        cin >> pairs;
+    }
+    data.shortestDistanceBenchmark(pairs);
+}
+/**
+ * @brief Finds the shortest trip, in distance flown, between the locations given by the user.
+ * @details Time complexity - O((V+E) log V), where V is the number of airports and E the number of flights.
+ */
+void Menu::listShortestDistanceOption() {
+    string sourceMode, source, destMode, dest;
+    cout << "Enter a starting location:" << endl;
+    if(!flightOptionsInput(sourceMode,source)){
+        return;
+    }
+
+    cout << "Enter a destination location:" << endl;
+    if(!flightOptionsInput(destMode,dest)){
+        return;
+    }
+    AirlineFilter allowed = getAllowedFilter();
+    string option;
+    cout << "Search with:" << endl;
+    cout << "1. Dijkstra" << endl;
+    cout << "2. A* (guided by the geographical distance to the destination)" << endl;
+    cout << "3. Contraction hierarchy" << endl;
+    cout << "Enter your answer:";
+    cin >> option;
+    while(cin.fail() || (option != "1" && option != "2" && option != "3")){
+        cin.clear();
+        cin.ignore();
+        cout << "Invalid answer - try again" << endl;
+        cout << "Enter your answer:";
+        cin >> option;
+    }
+    string algorithm = option == "1" ? "dijkstra" : option == "2" ? "astar" : "ch";
+    data.shortestDistanceOption(sourceMode,source,destMode,dest,allowed,algorithm);
+}
 /**
  * @brief Lists various network statistics based on user input.
  */
@@ -102,6 +225,9 @@ void Menu::listNetworkStatistics() {
                         case 2:
                             data.numberOfFlightsPerCity_Airline("airline");
                             break;
+                        case 3:
+                            data.numberOfFlightsPerCity_Airline("country");
+                            break;
                         default:
                             std::cout << "Invalid option try again" << std::endl;
                     }
@@ -141,7 +267,22 @@ void Menu::listNetworkStatistics() {
                     cout << "Enter k:";
                     cin >> k;
                 }
-                data.topKAirports(k);
+                switch(topKRankingOptions()){
+                    case 2:
+                        data.topKAirports(k, "in");
+                        break;
+                    case 3:
+                        data.topKAirports(k, "out");
+                        break;
+                    case 4:
+                        data.topKAirports(k, "airlines");
+                        break;
+                    case 5:
+                        data.topKAirports(k, "destinations");
+                        break;
+                    default:
+                        data.topKAirports(k, "flights");
+                }
                 break;
             case 7:
                 data.checkMaximumTripStops();
@@ -149,12 +290,35 @@ void Menu::listNetworkStatistics() {
             case 9:
                 data.checkEssentialAirports();
                 break;
+            case 10:
+                data.reachabilityReport();
+                break;
             default:
                 std::cout << "Invalid option try again" << std::endl;
         }
         option = networkStatisticsOptions();
     }
 }
+/**
+ * @brief Displays the rankings of the top-k airports.
+ * @return The selected ranking, any other answer ranks by flights.
+ */
+int Menu::topKRankingOptions() const{
+    int option;
+    cout << "1. Rank by flights (incoming and outgoing)" << endl;
+    cout << "2. Rank by incoming flights" << endl;
+    cout << "3. Rank by outgoing flights" << endl;
+    cout << "4. Rank by distinct airlines flying out" << endl;
+    cout << "5. Rank by distinct destinations" << endl;
+    cout << "Enter your option:";
+    cin >> option;
+    if(cin.fail()){
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        option = 1;
+    }
+    return option;
+}
 /**
  * @brief Displays network statistics menu options.
  * @return The selected menu option.
@@ -170,6 +334,7 @@ int Menu::networkStatisticsOptions() const{
     cout << "7. Check maximum trip and the pair(s) of the corresponding airports"<< endl;// number of destinations means sum of airports,cities and countries
     cout << "8. Check the top-k airport with the greatest air traffic capacity" << endl;
     cout << "9. Check the essential airports" << endl;
+    cout << "10. Generate the reachability report of every airport" << endl;
     cout<< "0. Back to main menu"<<endl;
     cout << "Enter your option:";
     cin >> option;
@@ -183,6 +348,7 @@ int Menu::flightsPerCity_AirlineOptions() const{
     int option;
     cout << "1. Check number of flights choosing a city" << endl;
     cout << "2. Check number of flights choosing an airline" << endl;
+    cout << "3. Check number of flights choosing a country" << endl;
     cout << "0. Go back" << endl;
     cout << "Enter your option:";
     cin >> option;
@@ -209,6 +375,13 @@ int Menu::menuOptions() const {
     int option;
     std::cout << "1. List network statistics" << std::endl;
     std::cout << "2. List best flight options" << std::endl;
+    std::cout << "3. Find the shortest trip in distance flown" << std::endl;
+    std::cout << "4. Benchmark the shortest distance queries" << std::endl;
+    std::cout << "5. Benchmark the csv reader" << std::endl;
+    std::cout << "6. Apply network updates from a file" << std::endl;
+    std::cout << "7. List the airports nearest to a location" << std::endl;
+    std::cout << "8. Benchmark the catchment queries" << std::endl;
+    std::cout << "9. Check the accuracy of the flight distances" << std::endl;
     std::cout << "0. Exit" << std::endl;
     std::cout << "Enter your option:";
     std::cin >> option;
@@ -229,6 +402,8 @@ bool Menu::flightOptionsInput(string &mode, string &searchTerm) {
     cout << "2. Airport name" << endl;
     cout << "3. City name" << endl;
     cout << "4. Geographical coordinates" << endl;
+    cout << "5. Airports within a distance of geographical coordinates" << endl;
+    cout << "6. Airports nearest to geographical coordinates" << endl;
     cout << "0.Go back" << endl;
     cout << "Enter your answer:";
     bool valid = false;
@@ -247,6 +422,12 @@ bool Menu::flightOptionsInput(string &mode, string &searchTerm) {
         } else if(option == "4") {
             mode = "geoCoords";
             valid = true;
+        } else if(option == "5") {
+            mode = "geoRadius";
+            valid = true;
+        } else if(option == "6") {
+            mode = "geoNearest";
+            valid = true;
         } else if(option == "0") {
             return false;
         }else{
@@ -291,38 +472,73 @@ bool Menu::flightOptionsInput(string &mode, string &searchTerm) {
     }
     else{
         double latitude,longitude;
-        cout << "Enter the latitude:";
-        cin >> latitude;
-        if(cin.fail() || latitude > 90 || latitude < - 90){
-            cin.clear();
-            cin.ignore();
-            cout << "Incorrect latitude - try again" << endl;
-            cout << "Enter the latitude:";
-            cin >> latitude;
+        coordinatesInput(latitude,longitude);
+        searchTerm = to_string(latitude) + "," + to_string(longitude);
+        if(mode == "geoRadius"){
+            double radius;
+            cout << "Enter the distance in km:";
+            cin >> radius;
+            while(cin.fail() || radius < 0){
+                cin.clear();
+                cin.ignore();
+                cout << "Incorrect distance - try again" << endl;
+                cout << "Enter the distance in km:";
+                cin >> radius;
+            }
+            searchTerm += "," + to_string(radius);
         }
-        cout << "Enter the longitude:";
-        cin >> longitude;
-        if(cin.fail() || longitude > 90 || longitude < - 90){
-            cin.clear();
-            cin.ignore();
-            cout << "Incorrect longitude - try again" << endl;
-            cout << "Enter the longitude:";
-            cin >> longitude;
+        else if(mode == "geoNearest"){
+            int k;
+            cout << "Enter the number of airports:";
+            cin >> k;
+            while(cin.fail() || k <= 0){
+                cin.clear();
+                cin.ignore();
+                cout << "Invalid number - try again" << endl;
+                cout << "Enter the number of airports:";
+                cin >> k;
+            }
+            searchTerm += "," + to_string(k);
         }
-        searchTerm = to_string(latitude) + "," + to_string(longitude);
     }
     return true;
 }
 
+/**
+ * @brief Reads a latitude and a longitude, in degrees, until both are within range.
+ * @param latitude Receives the latitude, between -90 and 90.
+ * @param longitude Receives the longitude, between -180 and 180.
+ * @details Time complexity - O(1)
+ */
+void Menu::coordinatesInput(double &latitude, double &longitude) {
+    cout << "Enter the latitude:";
+    cin >> latitude;
+    while(cin.fail() || latitude > 90 || latitude < -90){
+        cin.clear();
+        cin.ignore();
+        cout << "Incorrect latitude - try again" << endl;
+        cout << "Enter the latitude:";
+        cin >> latitude;
+    }
+    cout << "Enter the longitude:";
+    cin >> longitude;
+    while(cin.fail() || longitude > 180 || longitude < -180){
+        cin.clear();
+        cin.ignore();
+        cout << "Incorrect longitude - try again" << endl;
+        cout << "Enter the longitude:";
+        cin >> longitude;
+    }
+}
 /**
  * @brief Gets the list of allowed airlines from the user.
- * @return A unordered set of strings representing the allowed airlines.
+ * @return The filter of the allowed airlines, which allows every airline if the user enters 'all'.
  * @details Time complexity - O(k), where k is the number of allowed airlines.
  */
 
 
-unordered_set<string> Menu::getAllowedFilter() {
-    unordered_set<string> allowed;
+AirlineFilter Menu::getAllowedFilter() {
+    AirlineFilter allowed;
     string input = "balls";
     cout << "Enter the airlines that you choose to travel with:" << endl;
     while(input != "q" & input != "all"){
@@ -333,10 +549,18 @@ unordered_set<string> Menu::getAllowedFilter() {
             cin.ignore();
             cout << "Invalid input - try again" << endl;
         }
-        else{
-            allowed.insert(input);
+        else if(input == "all"){
+            allowed.allowAll();
+        }
+        else if(input != "q"){
+            int airline = data.findAirline(input);
+            if(airline == -1){
+                cout << "Airline not found" << endl;
+            }
+            else{
+                allowed.allow(airline);
+            }
         }
     }
-    allowed.erase("q");
     return allowed;
 }
@@ -20,14 +20,21 @@ class Menu {
     private:
         void listNetworkStatistics();
         void listBestFlightOptions();
+        void listShortestDistanceOption();
+        void benchmarkShortestDistance();
+        void applyNetworkUpdates();
+        void listNearestAirports();
+        void benchmarkCatchment();
         void exit();
         int menuOptions() const;
         int networkStatisticsOptions() const;
+        int topKRankingOptions() const;
         int flightsPerCity_AirlineOptions() const;
         int numberOfUniqueCountriesReachableOptions() const;
         bool flightOptionsInput(string &mode, string &searchTerm);
+        void coordinatesInput(double &latitude, double &longitude);
 
-    unordered_set<string> getAllowedFilter();
+    AirlineFilter getAllowedFilter();
 };
 
 
@@ -0,0 +1,108 @@
+#ifndef PROJETO_AED_2_MULTISOURCEBFS_H
+#define PROJETO_AED_2_MULTISOURCEBFS_H
+
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * @brief Set of sources of one multi-source bfs batch, one bit per source
+ * @details The fixed number of words lets the compiler turn every operation into a few SIMD instructions.
+ */
+struct SourceSet {
+    static const unsigned WORDS = 4;
+    uint64_t bits[WORDS];
+
+    void clear() {
+        for (unsigned i = 0; i < WORDS; i++) bits[i] = 0;
+    }
+    bool any() const {
+        uint64_t res = 0;
+        for (unsigned i = 0; i < WORDS; i++) res |= bits[i];
+        return res != 0;
+    }
+    void set(uint32_t source) {
+        bits[source / 64] |= uint64_t(1) << (source % 64);
+    }
+    void merge(const SourceSet &other) {
+        for (unsigned i = 0; i < WORDS; i++) bits[i] |= other.bits[i];
+    }
+    /** @brief Keeps only the sources that are not in other. */
+    void subtract(const SourceSet &other) {
+        for (unsigned i = 0; i < WORDS; i++) bits[i] &= ~other.bits[i];
+    }
+    /** @brief Calls f(source) for every source in the set, in ascending order. */
+    template <class F>
+    void forEach(F f) const {
+        for (unsigned i = 0; i < WORDS; i++)
+            for (uint64_t word = bits[i]; word != 0; word &= word - 1)
+                f(i * 64 + __builtin_ctzll(word));
+    }
+};
+
+/**
+ * @brief Class that runs a breadth-first search from up to BATCH sources at once over a frozen graph
+ * @details Every vertex keeps a bitset of the sources that already reached it and of the sources in the current
+ * frontier, so one sweep over the edges advances every source of the batch by one level. Running all the airports
+ * takes V/BATCH batches instead of V separate searches. An instance is not thread safe, use one per thread.
+ */
+class MultiSourceBFS {
+private:
+    const CSRGraph &csr_;
+    vector<SourceSet> seen_;
+    vector<SourceSet> frontier_;
+    vector<SourceSet> next_;
+
+public:
+    static const uint32_t BATCH = 64 * SourceSet::WORDS;
+
+    explicit MultiSourceBFS(const CSRGraph &csr) : csr_(csr), seen_(csr.numVertices()),
+        frontier_(csr.numVertices()), next_(csr.numVertices()) {}
+
+    /**
+     * @brief Runs the search from sources[0..count), count <= BATCH; bit i of every set stands for sources[i].
+     * @details After each level, calls onLevel(level, reached) where reached[v] holds the sources whose shortest
+     * path to v has exactly level edges. Level 0 holds every source itself.
+     * Time complexity - O(D*(V+E)*BATCH/64), where D is the largest eccentricity among the sources.
+     * @return The number of the last level that reached any vertex.
+     */
+    template <class F>
+    int run(const uint32_t *sources, uint32_t count, F onLevel) {
+        uint32_t n = csr_.numVertices();
+        for (uint32_t v = 0; v < n; v++) {
+            seen_[v].clear();
+            frontier_[v].clear();
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            seen_[sources[i]].set(i);
+            frontier_[sources[i]].set(i);
+        }
+        onLevel(0, frontier_);
+        int level = 0;
+        while (true) {
+            for (uint32_t v = 0; v < n; v++)
+                next_[v].clear();
+            for (uint32_t v = 0; v < n; v++) {
+                if (!frontier_[v].any())
+                    continue;
+                for (uint32_t e = csr_.begin(v); e < csr_.end(v); e++)
+                    next_[csr_.targets[e]].merge(frontier_[v]);
+            }
+            bool reached = false;
+            for (uint32_t v = 0; v < n; v++) {
+                next_[v].subtract(seen_[v]);
+                seen_[v].merge(next_[v]);
+                reached = reached || next_[v].any();
+            }
+            if (!reached)
+                return level;
+            frontier_.swap(next_);
+            onLevel(++level, frontier_);
+        }
+    }
+};
+
+
+#endif //PROJETO_AED_2_MULTISOURCEBFS_H
@@ -0,0 +1,63 @@
+#ifndef PROJETO_AED_2_NETWORKUPDATE_H
+#define PROJETO_AED_2_NETWORKUPDATE_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Struct that holds the fields of one change to the flight network, applied in place by Data::applyUpdates
+ * @details A batch file has one update per row: "add,Source,Target,Airline", "cancel,Source,Target,Airline",
+ * "open,Code,Name,City,Country,Latitude,Longitude" or "suspend,Airline".
+ */
+struct NetworkUpdate {
+    enum Type { ADD_FLIGHT, CANCEL_FLIGHT, OPEN_AIRPORT, SUSPEND_AIRLINE };
+
+    Type type = ADD_FLIGHT;
+    /** @brief Source airport of a flight, or code of the airport being opened */
+    string source;
+    /** @brief Target airport of a flight */
+    string target;
+    /** @brief Airline of a flight, or the airline being suspended */
+    string airline;
+    /** @brief Name, city, country and coordinates of the airport being opened */
+    string name, city, country;
+    double latitude = 0, longitude = 0;
+
+    static NetworkUpdate addFlight(const string &source, const string &target, const string &airline) {
+        NetworkUpdate update;
+        update.source = source;
+        update.target = target;
+        update.airline = airline;
+        return update;
+    }
+
+    static NetworkUpdate cancelFlight(const string &source, const string &target, const string &airline) {
+        NetworkUpdate update = addFlight(source, target, airline);
+        update.type = CANCEL_FLIGHT;
+        return update;
+    }
+
+    static NetworkUpdate openAirport(const string &code, const string &name, const string &city, const string &country,
+                                     double latitude, double longitude) {
+        NetworkUpdate update;
+        update.type = OPEN_AIRPORT;
+        update.source = code;
+        update.name = name;
+        update.city = city;
+        update.country = country;
+        update.latitude = latitude;
+        update.longitude = longitude;
+        return update;
+    }
+
+    static NetworkUpdate suspendAirline(const string &airline) {
+        NetworkUpdate update;
+        update.type = SUSPEND_AIRLINE;
+        update.airline = airline;
+        return update;
+    }
+};
+
+
+#endif //PROJETO_AED_2_NETWORKUPDATE_H
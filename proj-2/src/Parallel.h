@@ -0,0 +1,46 @@
+#ifndef PROJETO_AED_2_PARALLEL_H
+#define PROJETO_AED_2_PARALLEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Number of worker threads used by parallelFor, at least 1.
+ */
+inline unsigned numWorkers() {
+    unsigned n = thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Calls body(worker, i) for every i in [0, n), spreading the indices over numWorkers() threads.
+ * @details Indices are handed out in blocks of chunk from a shared atomic counter, so uneven work is
+ * balanced between the threads. worker is in [0, numWorkers()) and identifies the calling thread,
+ * which lets body keep per-thread state (traversal contexts, partial results) without locking.
+ * Returns once every index was processed.
+ */
+template <class F>
+void parallelFor(uint32_t n, F body, uint32_t chunk = 1) {
+    unsigned workers = numWorkers();
+    atomic<uint32_t> next(0);
+    auto run = [&](unsigned worker) {
+        for (uint32_t start = next.fetch_add(chunk); start < n; start = next.fetch_add(chunk)) {
+            uint32_t end = start + chunk < n ? start + chunk : n;
+            for (uint32_t i = start; i < end; i++)
+                body(worker, i);
+        }
+    };
+    vector<thread> threads;
+    for (unsigned worker = 1; worker < workers; worker++)
+        threads.emplace_back(run, worker);
+    run(0);
+    for (auto &t : threads)
+        t.join();
+}
+
+
+#endif //PROJETO_AED_2_PARALLEL_H
@@ -0,0 +1,121 @@
+#include "Snapshot.h"
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Appends a string table: the number of strings, their end offsets and then all their characters.
+ * @details Time complexity - O(n), where n is the total length of the strings
+ * @param strings The strings, read back by MappedSnapshot::getStrings in the same order.
+ */
+void SnapshotWriter::putStrings(const vector<string> &strings) {
+    vector<uint32_t> ends;
+    string blob;
+    for (const auto &s : strings) {
+        blob += s;
+        ends.push_back(blob.size());
+    }
+    put((uint32_t) strings.size());
+    putArray(ends.data(), ends.size());
+    put((uint32_t) blob.size());
+    putArray(blob.data(), blob.size());
+}
+
+/**
+ * @brief Writes the snapshot to a file, replacing it only once it is complete.
+ * @details The data goes to path + ".tmp" first and is renamed over path, so a reader never maps a half written file.
+ * Time complexity - O(n), where n is the size of the snapshot
+ * @param path The file to write.
+ * @return Whether the file was written.
+ */
+bool SnapshotWriter::save(const string &path) const {
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out.is_open() || !out.write(buffer_.data(), buffer_.size())) {
+            return false;
+        }
+    }
+    return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Unmaps the file.
+ * @details Time complexity - O(1)
+ */
+MappedSnapshot::~MappedSnapshot() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+/**
+ * @brief Maps a snapshot file read-only into memory.
+ * @details Time complexity - O(1), pages are only read from disk when touched
+ * @param path The file to map.
+ * @return Whether the file exists and could be mapped.
+ */
+bool MappedSnapshot::open(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<const char *>(data);
+    size_ = info.st_size;
+    pos_ = 0;
+    return true;
+}
+
+/**
+ * @brief Reads a string table written by SnapshotWriter::putStrings.
+ * @details Time complexity - O(n), where n is the total length of the strings
+ * @param strings Receives the strings.
+ * @return Whether the table was complete and consistent.
+ */
+bool MappedSnapshot::getStrings(vector<string> &strings) {
+    uint32_t count, length;
+    const uint32_t *ends;
+    const char *blob;
+    if (!get(count) || (ends = getArray<uint32_t>(count)) == nullptr || !get(length)
+        || (blob = getArray<char>(length)) == nullptr) {
+        return false;
+    }
+    strings.clear();
+    strings.reserve(count);
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (ends[i] < begin || ends[i] > length) {
+            return false;
+        }
+        strings.emplace_back(blob + begin, ends[i] - begin);
+        begin = ends[i];
+    }
+    return true;
+}
+
+/**
+ * @brief Summarizes the size and modification time of a file, to tell whether it changed since a snapshot was taken.
+ * @details Time complexity - O(1)
+ * @param path The file.
+ * @return The stamp, or 0 if the file does not exist.
+ */
+uint64_t MappedSnapshot::fileStamp(const string &path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return 0;
+    }
+    return ((uint64_t) info.st_mtime << 32) ^ (uint64_t) info.st_size;
+}
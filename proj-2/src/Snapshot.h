@@ -0,0 +1,93 @@
+#ifndef PROJETO_AED_2_SNAPSHOT_H
+#define PROJETO_AED_2_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Class that lays out a binary snapshot in memory and writes it to disk
+ * @details Arrays are aligned to 8 bytes so that a MappedSnapshot can read them in place.
+ */
+class SnapshotWriter {
+private:
+    vector<char> buffer_;
+
+    void align() {
+        buffer_.resize((buffer_.size() + 7) / 8 * 8, 0);
+    }
+
+public:
+    template <class T>
+    void put(const T &value) {
+        putArray(&value, 1);
+    }
+
+    /** @brief Appends count values, starting on an 8 byte boundary. */
+    template <class T>
+    void putArray(const T *data, size_t count) {
+        align();
+        size_t at = buffer_.size();
+        buffer_.resize(at + count * sizeof(T));
+        if (count > 0) {
+            memcpy(buffer_.data() + at, data, count * sizeof(T));
+        }
+    }
+
+    void putStrings(const vector<string> &strings);
+
+    bool save(const string &path) const;
+};
+
+/**
+ * @brief Class that maps a binary snapshot into memory and reads it back in the order it was written
+ * @details Every read is bounds checked and returns false (or nullptr) once the file is exhausted, so a truncated
+ * or corrupted file is rejected instead of read past its end. Arrays point straight into the mapping and stay valid
+ * until the snapshot is destroyed.
+ */
+class MappedSnapshot {
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+
+public:
+    MappedSnapshot() = default;
+    MappedSnapshot(const MappedSnapshot &) = delete;
+    MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+    ~MappedSnapshot();
+
+    bool open(const string &path);
+
+    template <class T>
+    bool get(T &value) {
+        const T *p = getArray<T>(1);
+        if (p == nullptr) {
+            return false;
+        }
+        value = *p;
+        return true;
+    }
+
+    /** @brief Pointer to the next count values in the mapping, or nullptr if the file is too short. */
+    template <class T>
+    const T *getArray(size_t count) {
+        size_t at = (pos_ + 7) / 8 * 8;
+        if (at > size_ || count > (size_ - at) / sizeof(T)) {
+            return nullptr;
+        }
+        pos_ = at + count * sizeof(T);
+        return reinterpret_cast<const T *>(data_ + at);
+    }
+
+    bool getStrings(vector<string> &strings);
+
+    static uint64_t fileStamp(const string &path);
+};
+
+
+#endif //PROJETO_AED_2_SNAPSHOT_H
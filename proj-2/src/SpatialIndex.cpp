@@ -0,0 +1,187 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+    const double RADIUS_EARTH = 6371000;
+
+    /** @brief Range of the implicit tree still to be searched, with a lower bound of its squared distance to the query */
+    struct Range {
+        uint32_t lo, hi;
+        double bound;
+    };
+}
+
+/**
+ * @brief Converts a coordinate to a point of the unit sphere.
+ * @details Time complexity - O(1)
+ */
+void SpatialIndex::toUnitVector(const Coordinate &coordinate, double xyz[3]) {
+    double lat = coordinate.getLatitude() * M_PI / 180.0;
+    double lon = coordinate.getLongitude() * M_PI / 180.0;
+    xyz[0] = cos(lat) * cos(lon);
+    xyz[1] = cos(lat) * sin(lon);
+    xyz[2] = sin(lat);
+}
+
+/**
+ * @brief Converts a squared chord of the unit sphere to the great-circle distance it spans on the Earth.
+ * @details Time complexity - O(1)
+ */
+double SpatialIndex::chordToMeters(double squaredChord) {
+    double half = sqrt(squaredChord) / 2;
+    return 2 * RADIUS_EARTH * asin(min(1.0, half));
+}
+
+/**
+ * @brief Converts a great-circle distance on the Earth to the chord it spans on the unit sphere.
+ * @details Time complexity - O(1)
+ */
+double SpatialIndex::metersToChord(double meters) {
+    double angle = min(M_PI, max(0.0, meters / RADIUS_EARTH));
+    return 2 * sin(angle / 2);
+}
+
+/**
+ * @brief Builds the tree over a set of coordinates, replacing the previous one.
+ * @details Time complexity - O(n log n), where n is the number of coordinates
+ * @param coordinates The coordinates, indexed by the id the queries report (the airport id).
+ */
+void SpatialIndex::build(const vector<Coordinate> &coordinates) {
+    points_.resize(coordinates.size());
+    axis_.assign(coordinates.size(), 0);
+    for (uint32_t i = 0; i < coordinates.size(); i++) {
+        toUnitVector(coordinates[i], points_[i].xyz);
+        points_[i].id = i;
+    }
+    build(0, points_.size());
+}
+
+/**
+ * @brief Turns points_[lo, hi) into a subtree rooted at its median, split along the axis where the range is widest.
+ * @details Time complexity - O(n log n), where n is hi - lo; the recursion is only O(log n) deep
+ */
+void SpatialIndex::build(uint32_t lo, uint32_t hi) {
+    if (hi - lo <= 1) {
+        return;
+    }
+    double low[3] = {2, 2, 2}, high[3] = {-2, -2, -2};
+    for (uint32_t i = lo; i < hi; i++) {
+        for (int a = 0; a < 3; a++) {
+            low[a] = min(low[a], points_[i].xyz[a]);
+            high[a] = max(high[a], points_[i].xyz[a]);
+        }
+    }
+    uint8_t axis = 0;
+    for (uint8_t a = 1; a < 3; a++) {
+        if (high[a] - low[a] > high[axis] - low[axis]) {
+            axis = a;
+        }
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    nth_element(points_.begin() + lo, points_.begin() + mid, points_.begin() + hi,
+                [axis](const Point &a, const Point &b) { return a.xyz[axis] < b.xyz[axis]; });
+    axis_[mid] = axis;
+    build(lo, mid);
+    build(mid + 1, hi);
+}
+
+/**
+ * @brief Number of indexed coordinates.
+ * @details Time complexity - O(1)
+ */
+uint32_t SpatialIndex::size() const {
+    return points_.size();
+}
+
+/**
+ * @brief Walks the tree near side first, calling visit(squaredChord, id) on every point closer than bound.
+ * @details visit may shrink bound to prune the rest of the search. Time complexity - O(log n + m) on average, where m is
+ * the number of points visited
+ */
+template <class Visit>
+void SpatialIndex::search(const double query[3], double &bound, Visit visit) const {
+    vector<Range> stack;
+    stack.push_back({0, (uint32_t) points_.size(), 0});
+    while (!stack.empty()) {
+        Range range = stack.back();
+        stack.pop_back();
+        if (range.lo >= range.hi || range.bound > bound) {
+            continue;
+        }
+        uint32_t mid = range.lo + (range.hi - range.lo) / 2;
+        const Point &p = points_[mid];
+        double dx = query[0] - p.xyz[0], dy = query[1] - p.xyz[1], dz = query[2] - p.xyz[2];
+        double d = dx * dx + dy * dy + dz * dz;
+        if (d <= bound) {
+            visit(d, p.id);
+        }
+        double diff = query[axis_[mid]] - p.xyz[axis_[mid]];
+        Range left{range.lo, mid, 0}, right{mid + 1, range.hi, 0};
+        Range &nearSide = diff < 0 ? left : right, &farSide = diff < 0 ? right : left;
+        farSide.bound = max(range.bound, diff * diff);
+        nearSide.bound = range.bound;
+        stack.push_back(farSide);
+        stack.push_back(nearSide); // popped first
+    }
+}
+
+/**
+ * @brief Finds the k indexed coordinates closest to a point.
+ * @details Time complexity - O(k log k + log n) on average, where n is the number of indexed coordinates
+ * @param coordinate The point.
+ * @param k The number of coordinates wanted, fewer are returned if the index is smaller.
+ * @param res Receives the great-circle distance in meters and the id of every coordinate found, closest first.
+ */
+void SpatialIndex::nearest(const Coordinate &coordinate, uint32_t k, vector<pair<double, uint32_t>> &res) const {
+    res.clear();
+    if (k == 0) {
+        return;
+    }
+    double query[3];
+    toUnitVector(coordinate, query);
+    priority_queue<pair<double, uint32_t>> best; // farthest of the k best on top
+    double bound = 5; // larger than any squared chord
+    search(query, bound, [&](double d, uint32_t id) {
+        if (best.size() < k) {
+            best.emplace(d, id);
+        } else if (d < best.top().first) {
+            best.pop();
+            best.emplace(d, id);
+        }
+        if (best.size() == k) {
+            bound = best.top().first;
+        }
+    });
+    while (!best.empty()) {
+        res.emplace_back(chordToMeters(best.top().first), best.top().second);
+        best.pop();
+    }
+    reverse(res.begin(), res.end());
+}
+
+/**
+ * @brief Finds every indexed coordinate within a great-circle distance of a point.
+ * @details Time complexity - O(m log m + log n) on average, where m is the number of coordinates found
+ * @param coordinate The point.
+ * @param radius The distance, in meters.
+ * @param res Receives the great-circle distance in meters and the id of every coordinate found, closest first.
+ */
+void SpatialIndex::withinRadius(const Coordinate &coordinate, double radius, vector<pair<double, uint32_t>> &res) const {
+    res.clear();
+    if (radius < 0) {
+        return;
+    }
+    double query[3];
+    toUnitVector(coordinate, query);
+    double chord = metersToChord(radius);
+    double bound = chord * chord * (1 + 1e-12);
+    search(query, bound, [&](double d, uint32_t id) {
+        res.emplace_back(d, id);
+    });
+    sort(res.begin(), res.end());
+    for (auto &found : res) {
+        found.first = chordToMeters(found.first);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef PROJETO_AED_2_SPATIALINDEX_H
+#define PROJETO_AED_2_SPATIALINDEX_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Coordinate.h"
+
+using namespace std;
+
+/**
+ * @brief Class that finds the airports closest to a point of the globe with a k-d tree
+ * @details Every coordinate is stored as a point of the unit sphere in 3D. The straight (chord) distance between two such
+ * points grows with the great-circle distance between the coordinates, so the tree can prune with plain squared
+ * euclidean distances and no trigonometry, and wraps around the antimeridian and the poles for free.
+ * The tree is implicit: the points are reordered so that the median of every range is its node, and only the split axis
+ * of every node is stored. Queries keep their own stack and are safe to run concurrently.
+ */
+class SpatialIndex {
+private:
+    struct Point {
+        double xyz[3];
+        uint32_t id;
+    };
+
+    /** @brief The points, reordered as an implicit tree */
+    vector<Point> points_;
+    /** @brief Split axis of the node at every position */
+    vector<uint8_t> axis_;
+
+    void build(uint32_t lo, uint32_t hi);
+    template <class Visit>
+    void search(const double query[3], double &bound, Visit visit) const;
+
+    static void toUnitVector(const Coordinate &coordinate, double xyz[3]);
+    static double chordToMeters(double squaredChord);
+    static double metersToChord(double meters);
+
+public:
+    void build(const vector<Coordinate> &coordinates);
+    uint32_t size() const;
+
+    void nearest(const Coordinate &coordinate, uint32_t k, vector<pair<double, uint32_t>> &res) const;
+    void withinRadius(const Coordinate &coordinate, double radius, vector<pair<double, uint32_t>> &res) const;
+};
+
+
+#endif //PROJETO_AED_2_SPATIALINDEX_H
@@ -0,0 +1,176 @@
+#include "StronglyConnectedComponents.h"
+#include <algorithm>
+
+/**
+ * @brief Finds the strongly connected components of the flight graph, its condensation DAG and the reach of every component.
+ * @details Every airport gets a discovery time and a low link, the earliest discovery time of an airport still on the
+ * component stack that its subtree reaches through one flight. When the search leaves an airport whose low link is its own
+ * discovery time, the airports above it on the component stack are exactly its component.
+ * Time complexity - O(V + E log d + C * V / 64), where d is the largest out degree of a component and C the number of components
+ * @param csr The frozen flight graph.
+ */
+void StronglyConnectedComponents::build(const CSRGraph &csr) {
+    uint32_t n = csr.numVertices();
+    const uint32_t NONE = UINT32_MAX;
+    struct Frame {
+        uint32_t v;
+        uint32_t next;  // position of the next flight to look at
+    };
+    vector<uint32_t> disc(n, 0), low(n, 0);
+    vector<Frame> stack;
+    vector<uint32_t> pending;   // airports whose component is not complete yet
+    componentOf_.assign(n, NONE);
+    componentOffsets_.assign(1, 0);
+    componentAirports_.clear();
+    componentAirports_.reserve(n);
+    uint32_t time = 0;
+    for (uint32_t root = 0; root < n; root++) {
+        if (disc[root] != 0) {
+            continue;
+        }
+        disc[root] = low[root] = ++time;
+        pending.push_back(root);
+        stack.push_back({root, csr.begin(root)});
+        while (!stack.empty()) {
+            Frame &frame = stack.back();
+            uint32_t v = frame.v;
+            if (frame.next < csr.end(v)) {
+                uint32_t w = csr.targets[frame.next++];
+                if (disc[w] == 0) { // tree edge, frame is not used after the push
+                    disc[w] = low[w] = ++time;
+                    pending.push_back(w);
+                    stack.push_back({w, csr.begin(w)});
+                } else if (componentOf_[w] == NONE) { // w is still pending, so it is an ancestor or in the same component
+                    low[v] = min(low[v], disc[w]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (low[v] == disc[v]) {
+                uint32_t id = componentOffsets_.size() - 1;
+                uint32_t w;
+                do {
+                    w = pending.back();
+                    pending.pop_back();
+                    componentOf_[w] = id;
+                    componentAirports_.push_back(w);
+                } while (w != v);
+                componentOffsets_.push_back(componentAirports_.size());
+            }
+            if (!stack.empty()) {
+                uint32_t u = stack.back().v;
+                low[u] = min(low[u], low[v]);
+            }
+        }
+    }
+    buildCondensation(csr);
+    vector<uint32_t> identity(n);
+    for (uint32_t v = 0; v < n; v++) {
+        identity[v] = v;
+    }
+    reach_ = reachableLabels(identity, n);
+}
+
+/**
+ * @brief Builds the condensation DAG, with one edge between two components for all the flights between their airports.
+ * @details Time complexity - O(V + E log d)
+ */
+void StronglyConnectedComponents::buildCondensation(const CSRGraph &csr) {
+    dagOffsets_.assign(1, 0);
+    dagTargets_.clear();
+    for (uint32_t c = 0; c < numComponents(); c++) {
+        size_t first = dagTargets_.size();
+        for (uint32_t i = componentOffsets_[c]; i < componentOffsets_[c + 1]; i++) {
+            uint32_t v = componentAirports_[i];
+            for (uint32_t e = csr.begin(v); e < csr.end(v); e++) {
+                uint32_t d = componentOf_[csr.targets[e]];
+                if (d != c) {
+                    dagTargets_.push_back(d);
+                }
+            }
+        }
+        sort(dagTargets_.begin() + first, dagTargets_.end());
+        dagTargets_.erase(unique(dagTargets_.begin() + first, dagTargets_.end()), dagTargets_.end());
+        dagOffsets_.push_back(dagTargets_.size());
+    }
+}
+
+/**
+ * @brief Number of strongly connected components.
+ * @details Time complexity - O(1)
+ */
+uint32_t StronglyConnectedComponents::numComponents() const {
+    return componentOffsets_.size() - 1;
+}
+
+/**
+ * @brief Component of an airport; components reachable from it have smaller ids.
+ * @details Time complexity - O(1)
+ */
+uint32_t StronglyConnectedComponents::componentOf(uint32_t airport) const {
+    return componentOf_[airport];
+}
+
+/**
+ * @brief Number of airports of the i-th component.
+ * @details Time complexity - O(1)
+ */
+uint32_t StronglyConnectedComponents::componentSize(uint32_t i) const {
+    return componentOffsets_[i + 1] - componentOffsets_[i];
+}
+
+/**
+ * @brief Airports of the i-th component.
+ * @details Time complexity - O(s), where s is the size of the component
+ */
+vector<uint32_t> StronglyConnectedComponents::component(uint32_t i) const {
+    return vector<uint32_t>(componentAirports_.begin() + componentOffsets_[i], componentAirports_.begin() + componentOffsets_[i + 1]);
+}
+
+/**
+ * @brief Components the i-th component has flights to, in the condensation DAG.
+ * @details Time complexity - O(d), where d is the out degree of the component
+ */
+vector<uint32_t> StronglyConnectedComponents::successors(uint32_t i) const {
+    return vector<uint32_t>(dagTargets_.begin() + dagOffsets_[i], dagTargets_.begin() + dagOffsets_[i + 1]);
+}
+
+/**
+ * @brief Number of airports reachable from an airport with any number of flights, the airport itself included.
+ * @details Time complexity - O(1)
+ */
+uint32_t StronglyConnectedComponents::reachableAirports(uint32_t airport) const {
+    return reach_[componentOf_[airport]];
+}
+
+/**
+ * @brief Number of distinct labels, such as cities or countries, among the airports reachable from every component.
+ * @details Every component ORs the label bitset of its own airports with those of its successors, which have smaller ids
+ * and are therefore complete already.
+ * Time complexity - O(V + (C + D) * L / 64), where D is the number of edges of the DAG and L the number of labels
+ * @param labelOf Label of every airport, below numLabels.
+ * @param numLabels The number of labels.
+ * @return The number of labels reachable from every component, indexed by component.
+ */
+vector<uint32_t> StronglyConnectedComponents::reachableLabels(const vector<uint32_t> &labelOf, uint32_t numLabels) const {
+    size_t words = (numLabels + 63) / 64;
+    vector<uint64_t> bits(numComponents() * words, 0);
+    vector<uint32_t> res(numComponents(), 0);
+    for (uint32_t c = 0; c < numComponents(); c++) {
+        uint64_t *row = bits.data() + c * words;
+        for (uint32_t i = componentOffsets_[c]; i < componentOffsets_[c + 1]; i++) {
+            uint32_t label = labelOf[componentAirports_[i]];
+            row[label / 64] |= (uint64_t) 1 << (label % 64);
+        }
+        for (uint32_t i = dagOffsets_[c]; i < dagOffsets_[c + 1]; i++) {
+            const uint64_t *successor = bits.data() + dagTargets_[i] * words;
+            for (size_t w = 0; w < words; w++) {
+                row[w] |= successor[w];
+            }
+        }
+        for (size_t w = 0; w < words; w++) {
+            res[c] += __builtin_popcountll(row[w]);
+        }
+    }
+    return res;
+}
@@ -0,0 +1,46 @@
+#ifndef PROJETO_AED_2_STRONGLYCONNECTEDCOMPONENTS_H
+#define PROJETO_AED_2_STRONGLYCONNECTEDCOMPONENTS_H
+
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * @brief Class that decomposes the flight network into strongly connected components and their condensation DAG
+ * @details Tarjan's depth first search runs with an explicit stack of (airport, next flight) frames over integer ids, so
+ * its depth is not bounded by the call stack. It completes a component only after every component reachable from it,
+ * so the component ids are already a reverse topological order of the condensation: every DAG edge goes from a higher
+ * id to a lower one. Walking the ids upwards then gives, in one pass over the DAG, the set of airports (or of any
+ * grouping of them, such as cities or countries) every component can reach.
+ */
+class StronglyConnectedComponents {
+private:
+    /** @brief Component of every airport */
+    vector<uint32_t> componentOf_;
+    /** @brief Airports of every component, grouped as in a CSR */
+    vector<uint32_t> componentOffsets_;
+    vector<uint32_t> componentAirports_;
+    /** @brief Condensation DAG, the components every component has flights to, grouped as in a CSR */
+    vector<uint32_t> dagOffsets_;
+    vector<uint32_t> dagTargets_;
+    /** @brief Number of airports reachable from every component, its own included */
+    vector<uint32_t> reach_;
+
+    void buildCondensation(const CSRGraph &csr);
+
+public:
+    void build(const CSRGraph &csr);
+
+    uint32_t numComponents() const;
+    uint32_t componentOf(uint32_t airport) const;
+    uint32_t componentSize(uint32_t i) const;
+    vector<uint32_t> component(uint32_t i) const;
+    vector<uint32_t> successors(uint32_t i) const;
+    uint32_t reachableAirports(uint32_t airport) const;
+    vector<uint32_t> reachableLabels(const vector<uint32_t> &labelOf, uint32_t numLabels) const;
+};
+
+
+#endif //PROJETO_AED_2_STRONGLYCONNECTEDCOMPONENTS_H
@@ -0,0 +1,48 @@
+#include "SymbolTable.h"
+
+/**
+ * @brief Returns the id of a string, assigning the next free id if it was never seen.
+ * @details Time complexity - O(1) on average
+ * @param name The string to intern.
+ * @return The id of the string.
+ */
+uint32_t SymbolTable::intern(const string& name) {
+    auto inserted = ids_.emplace(name, names_.size());
+    if (inserted.second) {
+        names_.push_back(name);
+    }
+    return inserted.first->second;
+}
+
+/**
+ * @brief Looks up the id of a string without interning it.
+ * @details Time complexity - O(1) on average
+ * @param name The string to look up.
+ * @return The id of the string, or -1 if it was never interned.
+ */
+int SymbolTable::find(const string& name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Getter for the string with a given id.
+ * @details Time complexity - O(1)
+ * @param id The id of the string.
+ * @return A constant reference to the interned string.
+ */
+const string& SymbolTable::getName(uint32_t id) const {
+    return names_[id];
+}
+
+/**
+ * @brief Getter for the number of interned strings.
+ * @details Time complexity - O(1)
+ * @return The number of ids handed out so far.
+ */
+uint32_t SymbolTable::size() const {
+    return names_.size();
+}
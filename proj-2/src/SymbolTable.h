@@ -0,0 +1,28 @@
+#ifndef PROJETO_AED_2_SYMBOLTABLE_H
+#define PROJETO_AED_2_SYMBOLTABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+/**
+ * @brief Class that interns strings (airport and airline codes) into dense integer ids
+ */
+class SymbolTable {
+private:
+    /** @brief A hash map that associates every interned string with its id */
+    unordered_map<string, uint32_t> ids_;
+    /** @brief The interned strings, indexed by id */
+    vector<string> names_;
+
+public:
+    uint32_t intern(const string& name);
+    int find(const string& name) const;
+    const string& getName(uint32_t id) const;
+    uint32_t size() const;
+};
+
+
+#endif //PROJETO_AED_2_SYMBOLTABLE_H
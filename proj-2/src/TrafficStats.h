@@ -0,0 +1,23 @@
+#ifndef PROJETO_AED_2_TRAFFICSTATS_H
+#define PROJETO_AED_2_TRAFFICSTATS_H
+
+#include <cstdint>
+
+/**
+ * @brief Struct that holds the traffic of a group of airports (one airport, a city or a country)
+ * @details Flights are counted once per flight, including those between two airports of the group; the distinct
+ * counts are over the flights leaving the group.
+ */
+struct TrafficStats {
+    uint32_t flightsIn = 0;
+    uint32_t flightsOut = 0;
+    /** @brief Distinct airlines flying out */
+    uint32_t airlines = 0;
+    /** @brief Distinct airports, cities and countries flown to */
+    uint32_t destinations = 0;
+    uint32_t cities = 0;
+    uint32_t countries = 0;
+};
+
+
+#endif //PROJETO_AED_2_TRAFFICSTATS_H
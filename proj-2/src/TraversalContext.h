@@ -0,0 +1,74 @@
+#ifndef PROJETO_AED_2_TRAVERSALCONTEXT_H
+#define PROJETO_AED_2_TRAVERSALCONTEXT_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+/**
+ * @brief Class that holds the auxiliary state of one graph traversal (visited marks, distances, low links), indexed by vertex id
+ * @details Every mark is stamped with the epoch of the traversal that wrote it, so reset() starts a new
+ * traversal in O(1) instead of clearing all vertices. Each query (or thread) owns its own context,
+ * which lets many traversals run at once over the same read-only graph.
+ */
+class TraversalContext {
+private:
+    /** @brief Epoch of the traversal that visited every vertex */
+    vector<uint32_t> visited_;
+    /** @brief Epoch of the traversal that has every vertex on its stack */
+    vector<uint32_t> processing_;
+    /** @brief Distance (or discovery number) of every visited vertex */
+    vector<int> dist_;
+    /** @brief Low link of every visited vertex */
+    vector<int> low_;
+    /** @brief Epoch of the current traversal, never 0 */
+    uint32_t epoch_ = 1;
+
+public:
+    TraversalContext() = default;
+
+    explicit TraversalContext(uint32_t numVertices) {
+        reset(numVertices);
+    }
+
+    /**
+     * @brief Starts a new traversal over a graph with numVertices vertices.
+     * @details Time complexity - O(1), except when the graph grew or the epoch counter wraps around
+     */
+    void reset(uint32_t numVertices) {
+        if (visited_.size() < numVertices) {
+            visited_.resize(numVertices, 0);
+            processing_.resize(numVertices, 0);
+            dist_.resize(numVertices, 0);
+            low_.resize(numVertices, 0);
+        }
+        if (++epoch_ == 0) {
+            fill(visited_.begin(), visited_.end(), 0);
+            fill(processing_.begin(), processing_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    bool isVisited(uint32_t v) const { return visited_[v] == epoch_; }
+
+    /** @brief Marks v as visited at distance dist. */
+    void visit(uint32_t v, int dist) {
+        visited_[v] = epoch_;
+        dist_[v] = dist;
+    }
+
+    /** @brief Distance of v in the current traversal, or -1 if v was not visited. */
+    int getDist(uint32_t v) const { return isVisited(v) ? dist_[v] : -1; }
+
+    int getLow(uint32_t v) const { return low_[v]; }
+
+    void setLow(uint32_t v, int low) { low_[v] = low; }
+
+    bool isProcessing(uint32_t v) const { return processing_[v] == epoch_; }
+
+    void setProcessing(uint32_t v, bool p) { processing_[v] = p ? epoch_ : 0; }
+};
+
+
+#endif //PROJETO_AED_2_TRAVERSALCONTEXT_H